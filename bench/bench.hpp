@@ -0,0 +1,30 @@
+#ifndef SQLITEPP_BENCH_HPP_INCLUDED
+#define SQLITEPP_BENCH_HPP_INCLUDED
+
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+
+// Iteration count from command line, or default.
+inline unsigned long bench_iterations(int argc, char** argv, unsigned long n)
+{
+    return argc > 1 ? std::strtoul(argv[1], nullptr, 10) : n;
+}
+
+// Run f() n times, print and return average nanoseconds per call.
+template<typename F>
+double bench(char const* name, unsigned long n, F f)
+{
+    auto const start = std::chrono::steady_clock::now();
+    for (unsigned long i = 0; i < n; ++i) f();
+    auto const stop = std::chrono::steady_clock::now();
+
+    double const ns = std::chrono::duration<double, std::nano>(stop - start).count() / n;
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(12) << std::fixed << std::setprecision(1) << ns << " ns/op"
+              << std::setw(14) << std::setprecision(0) << 1e9 / ns << " op/s" << std::endl;
+    return ns;
+}
+
+#endif // SQLITEPP_BENCH_HPP_INCLUDED
@@ -0,0 +1,61 @@
+// Point queries on the calling thread versus through async_session,
+// one at a time and pipelined so the worker takes them in batches.
+
+#include <cstdio>
+#include <vector>
+
+#include <sqlitepp/async_session.hpp>
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/typed_statement.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 100000);
+    char const* const filename = "bench_async_session.db";
+    std::remove(filename);
+    {
+        session db(filename);
+        db << "create table t(id integer primary key, name text)";
+        db << "with recursive n(i) as (select 1 union all select i + 1 from n where i < 1000) "
+              "insert into t select i, 'name' from n";
+    }
+
+    {
+        session db(filename);
+        typed_statement<std::tuple<u8string>(int)> st(db, "select name from t where id = ?");
+        int id = 0;
+        bench("blocking query", n, [&]
+        {
+            id = id % 1000 + 1;
+            st.query(id);
+        });
+    }
+
+    async_session db(filename);
+    int id = 0;
+    bench("async query, awaited one by one", n, [&]
+    {
+        id = id % 1000 + 1;
+        db.query<u8string>("select name from t where id = ?", id).get();
+    });
+
+    std::vector<async_result<std::vector<std::tuple<u8string>>>> results;
+    results.reserve(1000);
+    bench("async query, 1000 in flight", n, [&]
+    {
+        id = id % 1000 + 1;
+        results.push_back(db.query<u8string>("select name from t where id = ?", id));
+        if ( results.size() == 1000 )
+        {
+            for (auto& r : results) r.get();
+            results.clear();
+        }
+    });
+    std::cout << "batches: " << db.batches() << std::endl;
+    db.stop();
+    std::remove(filename);
+}
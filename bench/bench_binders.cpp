@@ -0,0 +1,89 @@
+// Heap allocations and time per statement with use/into binders.
+
+#include <cstdlib>
+#include <new>
+
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "bench.hpp"
+
+static unsigned long long allocations = 0;
+
+void* operator new(std::size_t size)
+{
+    ++allocations;
+    if ( void* p = std::malloc(size ? size : 1) ) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    std::free(p);
+}
+
+// Count allocations of one f() call.
+template<typename F>
+static void count(char const* name, F f)
+{
+    unsigned long long const start = allocations;
+    f();
+    std::cout << std::left << std::setw(40) << name
+              << std::right << std::setw(12) << allocations - start << " allocations" << std::endl;
+}
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 200000);
+
+    session db(":memory:");
+    db << "create table t(c0 integer, c1 integer, c2 integer, c3 integer, c4 real,"
+          " c5 real, c6 real, c7 text, c8 text, c9 text)";
+
+    int i0 = 0, i1 = 1, i2 = 2, i3 = 3;
+    double d4 = 4, d5 = 5, d6 = 6;
+    std::string s7 = "seven", s8 = "eight", s9 = "nine";
+
+    statement st(db);
+    auto prepare = [&]
+    {
+        st << "insert into t values(?, ?, ?, ?, ?, ?, ?, ?, ?, ?)",
+            use(i0), use(i1), use(i2), use(i3), use(d4), use(d5), use(d6), use(s7), use(s8), use(s9);
+        st.prepare();
+    };
+    auto row = [&]
+    {
+        ++i0;
+        st.reset(true);
+        st.exec();
+    };
+
+    prepare(); // warm up statement cache
+    count("prepare 10-column insert", prepare);
+    count("rebind and insert row", row);
+
+    int c0, c1, c2, c3;
+    double c4, c5, c6;
+    std::string c7, c8, c9;
+    auto select = [&]
+    {
+        st << "select * from t",
+            into(c0), into(c1), into(c2), into(c3), into(c4), into(c5), into(c6), into(c7), into(c8), into(c9);
+        st.exec();
+    };
+    select();
+    count("prepare 10-column select and step", select);
+
+    bench("prepare 10-column insert", n, prepare);
+    bench("rebind and insert row", n, row);
+    bench("prepare 10-column select and step", n, select);
+}
@@ -0,0 +1,46 @@
+// Reading a multi-MB BLOB whole versus streaming it in chunks.
+
+#include <vector>
+
+#include <sqlitepp/blob_stream.hpp>
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 200);
+    std::size_t const size = 8 * 1024 * 1024;
+
+    session db(":memory:");
+    db << "create table t(data blob)";
+    db << "insert into t values(zeroblob(8388608))";
+
+    unsigned long long sum = 0;
+
+    // the whole value is materialized by SQLite and copied out
+    statement st(db, "select data from t");
+    bench("8 MiB BLOB, column_value copy", n, [&]
+    {
+        st.reset();
+        st.exec();
+        blob const b = st.get<blob>(0);
+        std::vector<char> copy(static_cast<char const*>(b.data), static_cast<char const*>(b.data) + b.size);
+        sum += copy.size();
+    });
+
+    // peak memory is one chunk
+    std::vector<char> chunk(64 * 1024);
+    blob_stream bs(db, "t", "data", 1);
+    bench("8 MiB BLOB, blob_stream 64 KiB chunks", n, [&]
+    {
+        for (std::size_t offset = 0; offset < size; offset += chunk.size())
+        {
+            sum += bs.read(offset, chunk.data(), chunk.size());
+        }
+    });
+    std::cout << "checksum " << sum << std::endl;
+}
@@ -0,0 +1,72 @@
+// Insert rows with use() binders compared to bulk_insert.
+
+#include <string>
+#include <vector>
+
+#include <sqlitepp/bulk_insert.hpp>
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+#include <sqlitepp/transaction.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 1000000);
+
+    session db(":memory:");
+    db << "create table t1(a integer, b integer, c real, d text)";
+    db << "create table t2(a integer, b integer, c real, d text)";
+    db << "create table t3(a integer, b integer, c real, d text)";
+    db << "create table t4(a integer, b integer, c real, d text)";
+
+    std::vector<int> a(n), b(n);
+    std::vector<double> c(n);
+    std::vector<std::string> d(n);
+    for (unsigned long i = 0; i < n; ++i)
+    {
+        a[i] = static_cast<int>(i);
+        b[i] = static_cast<int>(i * 7);
+        c[i] = i * 0.5;
+        d[i] = "row " + std::to_string(i);
+    }
+
+    {
+        int ia, ib;
+        double dc;
+        std::string sd;
+        statement st(db);
+        st << "insert into t1 values(?, ?, ?, ?)", use(ia), use(ib), use(dc), use(sd);
+        transaction txn(db, transaction::immediate);
+        unsigned long i = 0;
+        bench("use binders, reset(true) and exec", n, [&]
+        {
+            ia = a[i]; ib = b[i]; dc = c[i]; sd = d[i];
+            ++i;
+            st.reset(true);
+            st.exec();
+        });
+        txn.commit();
+    }
+
+    auto bulk = [&](char const* name, char const* sql, std::size_t batch_rows)
+    {
+        bulk_insert::options opts;
+        opts.batch_rows = batch_rows;
+        bulk_insert bi(db, sql, opts);
+        auto const start = std::chrono::steady_clock::now();
+        bi.insert_columns(a, b, c, d);
+        bi.finish();
+        double const ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / n;
+        std::cout << std::left << std::setw(40) << name
+                  << std::right << std::setw(12) << std::fixed << std::setprecision(1) << ns << " ns/op"
+                  << std::setw(14) << std::setprecision(0) << bi.statistics().rows_per_second << " rows/s"
+                  << "  (" << bi.batch_rows() << " rows per statement)" << std::endl;
+    };
+    bulk("bulk_insert columns", "insert into t2 values(?, ?, ?, ?)", 1);
+    bulk("bulk_insert, 50-row VALUES", "insert into t3 values(?, ?, ?, ?)", 50);
+    bulk("bulk_insert, maximal VALUES", "insert into t4 values(?, ?, ?, ?)", 0);
+}
@@ -0,0 +1,72 @@
+// Commit latency of a WAL writer with automatic checkpoints
+// versus checkpoint_scheduler.
+
+#include <algorithm>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <sqlitepp/checkpoint_scheduler.hpp>
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+
+#include "bench.hpp"
+
+namespace {
+
+void commits(char const* name, bool scheduled, unsigned long n)
+{
+    using namespace sqlitepp;
+
+    std::string const file = std::string("bench_checkpoint_") + (scheduled ? "s" : "a") + ".db";
+    std::remove(file.c_str());
+    std::remove((file + "-wal").c_str());
+    std::remove((file + "-shm").c_str());
+
+    std::vector<double> latencies;
+    latencies.reserve(n);
+    {
+        session writer(file, session_options::oltp_wal());
+        writer.set_busy_policy(busy_policy());
+        writer << "create table t(id integer, data blob)";
+        std::unique_ptr<checkpoint_scheduler> cs;
+        if ( scheduled ) cs.reset(new checkpoint_scheduler(writer, file));
+
+        statement st(writer, "insert into t values(?, zeroblob(4000))");
+        st.prepare();
+        for (unsigned long i = 0; i < n; ++i)
+        {
+            auto const start = std::chrono::steady_clock::now();
+            st.use_value(1, static_cast<long long>(i));
+            st.exec();
+            st.reset();
+            latencies.push_back(std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count());
+        }
+        if ( cs )
+        {
+            checkpoint_scheduler::stats const s = cs->statistics();
+            std::cout << "  checkpoints " << s.checkpoints << ", max WAL pages " << s.max_wal_pages
+                      << ", max duration " << s.max_duration.count() / 1000 << " us" << std::endl;
+        }
+    }
+    std::remove(file.c_str());
+    std::remove((file + "-wal").c_str());
+    std::remove((file + "-shm").c_str());
+
+    std::sort(latencies.begin(), latencies.end());
+    std::cout << std::left << std::setw(40) << name << std::right << std::fixed << std::setprecision(1)
+              << " p50 " << latencies[n / 2] << " us"
+              << " p99 " << latencies[n * 99 / 100] << " us"
+              << " p99.9 " << latencies[n * 999 / 1000] << " us"
+              << " max " << latencies.back() << " us" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    unsigned long const n = bench_iterations(argc, argv, 20000);
+    commits("autocheckpoint", false, n);
+    commits("checkpoint_scheduler", true, n);
+}
@@ -0,0 +1,46 @@
+// Column lookup by name in a wide result set.
+
+#include <string>
+#include <vector>
+
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 1000000);
+    int const columns = 64;
+
+    std::string select = "select ";
+    std::vector<std::string> names;
+    for (int c = 0; c < columns; ++c)
+    {
+        names.push_back("column_" + std::to_string(c));
+        select += std::to_string(c) + " as " + names.back() + (c + 1 < columns ? ", " : "");
+    }
+
+    session db(":memory:");
+    statement st(db, select);
+    st.exec();
+
+    int c = 0;
+    long long sum = 0;
+    bench("column_index(name), 64 columns", n, [&]
+    {
+        sum += st.column_index(names[c]);
+        c = (c + 1) % columns;
+    });
+
+    std::vector<column_ref> refs;
+    for (auto const& name : names) refs.push_back(st.column(name));
+    bench("column_ref::get<int>(), 64 columns", n, [&]
+    {
+        sum += refs[c].get<int>();
+        c = (c + 1) % columns;
+    });
+    std::cout << "checksum " << sum << std::endl;
+}
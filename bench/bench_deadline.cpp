@@ -0,0 +1,46 @@
+// Cost of deadline checks by the progress handler on a scan of 1M rows,
+// by VM steps between checks.
+
+#include <chrono>
+
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 20);
+
+    session db(":memory:");
+    db << "create table t(id integer primary key, value integer)";
+    db << "with recursive n(i) as (select 1 union all select i + 1 from n where i < 1000000) "
+          "insert into t select i, i % 7 from n";
+
+    long long sum = 0;
+    statement st(db);
+    st << "select sum(value) from t where value > 2", into(sum);
+    auto const query = [&]
+    {
+        st.exec();
+        st.reset();
+    };
+
+    bench("scan, no deadline", n, query);
+    auto const far = std::chrono::steady_clock::now() + std::chrono::hours(1);
+    int const granularities[] = { 1, 10, 100, 1000, 10000 };
+    for (int steps : granularities)
+    {
+        db.set_deadline_granularity(steps);
+        db.set_deadline(far);
+        std::string const name = "scan, deadline check every " + std::to_string(steps);
+        bench(name.c_str(), n, query);
+        db.clear_deadline();
+    }
+
+    st.set_timeout(std::chrono::hours(1));
+    bench("scan, statement timeout, every 10000", n, query);
+}
@@ -0,0 +1,72 @@
+// Reading a result set row by row with into() versus in batches with fetch(n).
+
+#include <string>
+#include <vector>
+
+#include <sqlitepp/columns.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+#include <sqlitepp/string.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 200);
+    int const rows = 10000;
+
+    session db(":memory:");
+    db << "create table t(id integer, name text, value real)";
+    db << "begin";
+    for (int r = 0; r < rows; ++r)
+    {
+        db << "insert into t values(" + std::to_string(r) + ", 'name" + std::to_string(r) + "', 0.5)";
+    }
+    db << "commit";
+
+    std::size_t checksum = 0;
+
+    {
+        std::vector<int> ids;
+        std::vector<u8string> names;
+        std::vector<double> values;
+        int id;
+        u8string name;
+        double value;
+        statement st(db);
+        st << "select id, name, value from t", into(id), into(name), into(value);
+        double const ns = bench("into() per row, copied to vectors", n, [&]
+        {
+            ids.clear(); names.clear(); values.clear();
+            st.reset();
+            while ( st.exec() )
+            {
+                ids.push_back(id);
+                names.push_back(name);
+                values.push_back(value);
+            }
+            checksum += ids.size() + names.back().size();
+        });
+        std::cout << "per row: " << std::setprecision(2) << ns / rows << " ns" << std::endl;
+    }
+
+    {
+        std::vector<int> ids;
+        text_column names;
+        std::vector<double> values;
+        statement st(db);
+        st << "select id, name, value from t", into_rows(ids), into_rows(names), into_rows(values);
+        double const ns = bench("fetch(1000) into columns", n, [&]
+        {
+            ids.clear(); names.clear(); values.clear();
+            st.reset();
+            while ( st.fetch(1000) == 1000 ) {}
+            checksum += ids.size() + names[names.size() - 1].size;
+        });
+        std::cout << "per row: " << std::setprecision(2) << ns / rows << " ns"
+                  << " (checksum " << checksum << ")" << std::endl;
+    }
+}
@@ -0,0 +1,46 @@
+// Cost of wrapper timings on a point query, and of metrics snapshots.
+
+#include <sstream>
+
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 1000000);
+
+    session db(":memory:");
+    db << "create table t(id integer primary key, name text)";
+    db << "with recursive n(i) as (select 1 union all select i + 1 from n where i < 1000) "
+          "insert into t select i, 'name' from n";
+
+    int id = 0;
+    u8string name;
+    statement st(db);
+    st << "select name from t where id = ?", into(name), use(id);
+
+    auto const query = [&]
+    {
+        id = id % 1000 + 1;
+        st.reset(true);
+        st.exec();
+    };
+
+    bench("point query, timings off", n, query);
+    db.enable_timings(true);
+    bench("point query, timings on", n, query);
+
+    bench("session::metrics()", n / 10, [&] { db.metrics(); });
+    bench("statement::metrics()", n / 10, [&] { st.metrics(); });
+    bench("write_prometheus(session)", n / 100, [&]
+    {
+        std::ostringstream os;
+        write_prometheus(os, db.metrics(), "db=\"main\"");
+    });
+}
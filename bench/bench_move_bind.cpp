@@ -0,0 +1,34 @@
+// Binding large text payloads: copied by SQLite versus moved into statement.
+
+#include <string>
+
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 20000);
+    std::size_t const size = 64 * 1024;
+
+    session db(":memory:");
+    db << "create table t(payload text)";
+    statement st(db, "insert into t values(?)");
+    st.prepare();
+
+    // each payload is produced anew, as a producer would
+    bench("64 KiB text, SQLITE_TRANSIENT copy", n, [&]
+    {
+        std::string payload(size, 'x');
+        st.use_value(1, text(payload), true);
+    });
+
+    bench("64 KiB text, moved into statement", n, [&]
+    {
+        std::string payload(size, 'x');
+        st.use_value(1, std::move(payload));
+    });
+}
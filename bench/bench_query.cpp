@@ -0,0 +1,39 @@
+// Latency of ad-hoc statements built with session << "...".
+
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 200000);
+
+    session db(":memory:");
+    db << "create table t(id integer primary key, name text, value real)";
+
+    int i = 0;
+    bench("query << literal", n, []
+    {
+        query q;
+        q << "insert into t(name, value) values(:name, :value)";
+    });
+
+    bench("query << literal, number, text", n, [&i]
+    {
+        query q;
+        q << "select * from t where id = " << ++i << " and name = '" << text("x") << "'";
+    });
+
+    bench("session << select literal", n, [&db]
+    {
+        db << "select 1";
+    });
+
+    bench("session << insert with uses", n, [&db, &i]
+    {
+        db << "insert into t(name, value) values(:name, :value)", use(text("name")), use(++i * 0.5);
+    });
+}
@@ -0,0 +1,57 @@
+// Point query cost without slow query log, with log below and above threshold.
+
+#include <chrono>
+#include <vector>
+
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/slow_query_log.hpp>
+#include <sqlitepp/statement.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 1000000);
+
+    session db(":memory:");
+    db << "create table t(id integer primary key, name text)";
+    db << "with recursive n(i) as (select 1 union all select i + 1 from n where i < 1000) "
+          "insert into t select i, 'name' from n";
+
+    int id = 0;
+    u8string name;
+    statement st(db);
+    st << "select name from t where id = ?", into(name), use(id);
+
+    auto const query = [&]
+    {
+        id = id % 1000 + 1;
+        st.reset(true);
+        st.exec();
+    };
+
+    bench("point query, no log", n, query);
+    {
+        slow_query_log log(db, std::chrono::milliseconds(10));
+        bench("point query, below threshold", n, query);
+    }
+    {
+        slow_query_log::options opts;
+        opts.capacity = 1 << 16;
+        slow_query_log log(db, std::chrono::nanoseconds(0), opts);
+        std::vector<slow_query_log::record> records;
+        bench("point query, every run logged", n / 10, [&]
+        {
+            query();
+            if ( id == 1000 )
+            {
+                log.drain(records);
+                records.clear();
+            }
+        });
+    }
+}
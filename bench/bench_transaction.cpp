@@ -0,0 +1,48 @@
+// Per-transaction overhead of empty BEGIN/COMMIT pairs.
+//
+// "literal" streams the control statements into the session, which was the
+// transaction implementation before: once_query, std::ostringstream and a
+// prepare/finalize cycle per command. "transaction" uses the class, which
+// reuses statements prepared once per session.
+
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/transaction.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 100000);
+
+    session db(":memory:");
+    db << "create table t(id integer primary key, v integer)";
+
+    db.cache().capacity(0);
+    double const before = bench("literal begin/commit, no cache", n, [&db]
+    {
+        db << "begin immediate";
+        db << "commit";
+    });
+
+    db.cache().capacity(16);
+    bench("literal begin/commit, cached", n, [&db]
+    {
+        db << "begin immediate";
+        db << "commit";
+    });
+
+    double const after = bench("transaction begin/commit", n, [&db]
+    {
+        transaction t(db, transaction::immediate);
+        t.commit();
+    });
+
+    bench("transaction begin/rollback", n, [&db]
+    {
+        transaction t(db, transaction::immediate);
+    });
+
+    std::cout << "speedup: " << before / after << "x" << std::endl;
+}
@@ -0,0 +1,54 @@
+// Reading rows with into() binders compared to typed_statement.
+
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/typed_statement.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 200);
+    int const rows = 1000;
+
+    session db(":memory:");
+    db << "create table t(c0 integer, c1 integer, c2 integer, c3 integer, c4 real,"
+          " c5 real, c6 real, c7 text, c8 text, c9 text)";
+    {
+        typed_statement<std::tuple<>(int, int, int, int, double, double, double,
+            std::string, std::string, std::string)> insert(db, "insert into t values(?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+        db << "begin";
+        for (int i = 0; i < rows; ++i)
+        {
+            insert.exec(i, i + 1, i + 2, i + 3, i * 0.5, i * 1.5, i * 2.5, "seven", "eight", "nine");
+        }
+        db << "commit";
+    }
+
+    int c0, c1, c2, c3;
+    double c4, c5, c6;
+    std::string c7, c8, c9;
+    statement st(db);
+    st << "select * from t",
+        into(c0), into(c1), into(c2), into(c3), into(c4), into(c5), into(c6), into(c7), into(c8), into(c9);
+    st.prepare();
+
+    typed_statement<std::tuple<int, int, int, int, double, double, double,
+        std::string, std::string, std::string>()> ts(db, "select * from t");
+    decltype(ts)::row_type row;
+
+    double const binders = bench("into binders, 1000 rows", n, [&]
+    {
+        st.reset();
+        while ( st.exec() ) {}
+    });
+    double const typed = bench("typed_statement, 1000 rows", n, [&]
+    {
+        ts.bind();
+        while ( ts.fetch(row) ) {}
+    });
+    std::cout << "per row: " << binders / rows << " ns vs " << typed / rows << " ns" << std::endl;
+}
@@ -0,0 +1,51 @@
+// Reading wide result sets cell by cell with statement::get<T>().
+
+#include <string>
+
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/statement.hpp>
+
+#include "bench.hpp"
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 100);
+    int const columns = 64;
+    int const rows = 1000;
+
+    std::string create = "create table t(";
+    std::string insert = "insert into t values(";
+    for (int c = 0; c < columns; ++c)
+    {
+        char const* sep = c + 1 < columns ? ", " : ")";
+        create += (c % 2 ? "t" : "i") + std::to_string(c) + (c % 2 ? " text" : " integer") + sep;
+        insert += (c % 2 ? "'value'" : std::to_string(c)) + sep;
+    }
+
+    session db(":memory:");
+    db << create;
+    db << "begin";
+    for (int r = 0; r < rows; ++r) db << insert;
+    db << "commit";
+
+    statement st(db, "select * from t");
+    long long sum = 0;
+    std::size_t length = 0;
+
+    double const ns = bench("64 columns x 1000 rows", n, [&]
+    {
+        st.reset();
+        while ( st.exec() )
+        {
+            for (int c = 0; c < columns; c += 2)
+            {
+                sum += st.get<long long>(c);
+                length += st.get<text>(c + 1).size;
+            }
+        }
+    });
+    std::cout << "per cell: " << std::setprecision(2) << ns / (columns * rows) << " ns"
+              << " (checksum " << sum + length << ")" << std::endl;
+}
@@ -0,0 +1,88 @@
+// Throughput of small writes from many threads.
+//
+// "transaction per write" gives each thread its own session committing every
+// insert, so every write pays its own commit and waits for the write lock.
+// "write_batcher" queues the same inserts to one writer session which commits
+// them in groups.
+
+#include <cstdio>
+#include <future>
+#include <thread>
+#include <vector>
+
+#include <sqlitepp/session.hpp>
+#include <sqlitepp/transaction.hpp>
+#include <sqlitepp/use.hpp>
+#include <sqlitepp/write_batcher.hpp>
+
+#include "bench.hpp"
+
+static char const* const db_name = "bench_write_batcher.db";
+
+static void setup()
+{
+    std::remove(db_name);
+    sqlitepp::session db(db_name);
+    db << "pragma journal_mode = wal";
+    db << "create table t(id integer primary key, thread integer, value integer)";
+}
+
+int main(int argc, char** argv)
+{
+    using namespace sqlitepp;
+
+    unsigned long const n = bench_iterations(argc, argv, 4000);
+    unsigned const threads = 8;
+    unsigned long const per_thread = n / threads;
+
+    setup();
+    double const before = bench("transaction per write, total", 1, [&]
+    {
+        std::vector<std::thread> producers;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            producers.emplace_back([&, t]
+            {
+                session db(db_name);
+                db << "pragma busy_timeout = 60000";
+                for (unsigned long i = 0; i < per_thread; ++i)
+                {
+                    transaction txn(db, transaction::immediate);
+                    db << "insert into t(thread, value) values(?, ?)", use(t), use(i);
+                    txn.commit();
+                }
+            });
+        }
+        for (auto& p : producers) p.join();
+    }) / (threads * per_thread);
+
+    setup();
+    write_batcher wb(db_name);
+    double const after = bench("write_batcher, total", 1, [&]
+    {
+        std::vector<std::thread> producers;
+        for (unsigned t = 0; t < threads; ++t)
+        {
+            producers.emplace_back([&, t]
+            {
+                std::vector<std::future<void>> results;
+                for (unsigned long i = 0; i < per_thread; ++i)
+                {
+                    results.push_back(wb.submit([t, i](session& db)
+                    {
+                        db << "insert into t(thread, value) values(?, ?)", use(t), use(i);
+                    }));
+                }
+                for (auto& r : results) r.get();
+            });
+        }
+        for (auto& p : producers) p.join();
+    }) / (threads * per_thread);
+
+    std::cout << "writes: " << threads * per_thread << ", batches: " << wb.batches() << "\n"
+              << "per write: " << before << " ns vs " << after << " ns, speedup: "
+              << before / after << "x" << std::endl;
+
+    wb.stop();
+    std::remove(db_name);
+}
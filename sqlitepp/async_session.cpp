@@ -0,0 +1,228 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+
+#include <sqlite3.h>
+
+#include "async_session.hpp"
+#include "exception.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+async_state::async_state() noexcept
+    : cancelled(false)
+    , done_(false)
+{
+}
+//----------------------------------------------------------------------------
+
+async_state::~async_state() = default;
+//----------------------------------------------------------------------------
+
+void async_state::fail(std::exception_ptr e) noexcept
+{
+    error_ = e;
+}
+//----------------------------------------------------------------------------
+
+void async_state::complete(std::function<void (std::function<void()>)> const& executor)
+{
+    std::function<void()> continuation;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        done_ = true;
+        continuation.swap(continuation_);
+        done_cv_.notify_all();
+    }
+    if ( continuation )
+    {
+        if ( executor ) executor(std::move(continuation));
+        else continuation();
+    }
+}
+//----------------------------------------------------------------------------
+
+bool async_state::ready() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return done_;
+}
+//----------------------------------------------------------------------------
+
+void async_state::wait() const
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [this] { return done_; });
+}
+//----------------------------------------------------------------------------
+
+bool async_state::suspend(std::function<void()> continuation)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if ( done_ )
+    {
+        return false;
+    }
+    continuation_ = std::move(continuation);
+    return true;
+}
+//----------------------------------------------------------------------------
+
+void async_state::rethrow() const
+{
+    // error is written before done under the lock
+    if ( error_ )
+    {
+        std::rethrow_exception(error_);
+    }
+}
+//----------------------------------------------------------------------------
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////////
+
+async_session::async_session(text const& filename, options const& opts, unsigned flags)
+    : db_(filename, opts.tuning, flags)
+    , opts_(opts)
+    , stopped_(false)
+    , current_(nullptr)
+    , batches_(0)
+{
+    worker_ = std::thread(&async_session::run, this);
+}
+//----------------------------------------------------------------------------
+
+async_session::~async_session()
+{
+    stop();
+}
+//----------------------------------------------------------------------------
+
+void async_session::stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+        wakeup_.notify_one();
+    }
+    if ( worker_.joinable() )
+    {
+        worker_.join();
+    }
+}
+//----------------------------------------------------------------------------
+
+unsigned long long async_session::batches() const noexcept
+{
+    return batches_;
+}
+//----------------------------------------------------------------------------
+
+void async_session::push(std::shared_ptr<detail::async_state> op)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if ( stopped_ )
+    {
+        throw std::logic_error("async_session is stopped");
+    }
+    queue_.push_back(std::move(op));
+    wakeup_.notify_one();
+}
+//----------------------------------------------------------------------------
+
+void async_session::cancel(detail::async_state& op)
+{
+    op.cancelled = true;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if ( current_ == &op )
+    {
+        sqlite3_interrupt(db_.impl());
+    }
+}
+//----------------------------------------------------------------------------
+
+void async_session::cancel()
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (auto const& op : queue_)
+    {
+        op->cancelled = true;
+    }
+    if ( current_ )
+    {
+        current_->cancelled = true;
+        sqlite3_interrupt(db_.impl());
+    }
+}
+//----------------------------------------------------------------------------
+
+void async_session::run()
+{
+    std::vector<std::shared_ptr<detail::async_state>> batch;
+    for (;;)
+    {
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            wakeup_.wait(lock, [this] { return stopped_ || !queue_.empty(); });
+            if ( queue_.empty() )
+            {
+                // stopped and drained
+                break;
+            }
+            auto const end = queue_.begin() + std::min(queue_.size(), std::max<std::size_t>(opts_.max_batch, 1));
+            batch.assign(std::make_move_iterator(queue_.begin()), std::make_move_iterator(end));
+            queue_.erase(queue_.begin(), end);
+        }
+        ++batches_;
+
+        for (auto& op : batch)
+        {
+            {
+                // cancel sees the running operation, or the operation sees it cancelled
+                std::lock_guard<std::mutex> lock(mutex_);
+                current_ = op.get();
+            }
+            if ( op->cancelled )
+            {
+                op->fail(std::make_exception_ptr(interrupted()));
+            }
+            else
+            {
+                // sqlite3_interrupt is lost if no statement steps, so the
+                // session checks the flag before and while statements step
+                db_.cancel_ = &op->cancelled;
+                db_.watch_deadline();
+                op->run(db_);
+                db_.cancel_ = nullptr;
+                db_.watch_deadline();
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                current_ = nullptr;
+            }
+            op->complete(opts_.executor);
+        }
+        batch.clear();
+    }
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,417 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_ASYNC_SESSION_HPP_INCLUDED
+#define SQLITEPP_ASYNC_SESSION_HPP_INCLUDED
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "session.hpp"
+#include "statement.hpp"
+#include "transaction.hpp"
+#include "typed_statement.hpp"
+
+#if __cplusplus >= 202002L && __has_include(<coroutine>)
+#include <coroutine>
+#define SQLITEPP_HAS_COROUTINES 1
+#endif
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+class async_session;
+
+namespace detail {
+
+// Shared state of an asynchronous operation.
+class SQLITEPP_API async_state
+{
+public:
+    async_state() noexcept;
+    virtual ~async_state();
+
+    async_state(async_state const&) = delete;
+    async_state& operator=(async_state const&) = delete;
+
+    // Run operation, store its result or exception.
+    virtual void run(session& s) noexcept = 0;
+
+    // Store exception of operation.
+    void fail(std::exception_ptr e) noexcept;
+
+    // Mark done, wake waiters, run continuation with executor, or inline if null.
+    void complete(std::function<void (std::function<void()>)> const& executor);
+
+    // Is operation done?
+    bool ready() const;
+
+    // Wait until operation is done.
+    void wait() const;
+
+    // Set continuation run on completion, false if operation is done already.
+    bool suspend(std::function<void()> continuation);
+
+    // Throw exception of done operation, if any.
+    void rethrow() const;
+
+    // Cancellation requested.
+    std::atomic<bool> cancelled;
+
+private:
+    std::exception_ptr error_;
+    mutable std::mutex mutex_;
+    mutable std::condition_variable done_cv_;
+    bool done_;
+    std::function<void()> continuation_;
+};
+
+template<typename R>
+class async_value : public async_state
+{
+public:
+    std::unique_ptr<R> value;
+};
+
+template<>
+class async_value<void> : public async_state
+{
+};
+
+template<typename F, typename R>
+class async_task : public async_value<R>
+{
+public:
+    explicit async_task(F&& f) : f_(std::move(f)) {}
+
+    void run(session& s) noexcept override
+    {
+        try
+        {
+            this->value.reset(new R(f_(s)));
+        }
+        catch (...)
+        {
+            this->fail(std::current_exception());
+        }
+    }
+
+private:
+    F f_;
+};
+
+template<typename F>
+class async_task<F, void> : public async_value<void>
+{
+public:
+    explicit async_task(F&& f) : f_(std::move(f)) {}
+
+    void run(session& s) noexcept override
+    {
+        try
+        {
+            f_(s);
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
+    }
+
+private:
+    F f_;
+};
+
+template<typename R>
+R take(async_value<R>& state)
+{
+    return std::move(*state.value);
+}
+
+inline void take(async_value<void>&)
+{
+}
+
+// Statement with parameters, executed until done.
+template<typename... Params>
+struct exec_operation
+{
+    u8string sql;
+    std::tuple<Params...> params;
+
+    std::size_t operator()(session& s)
+    {
+        statement st(s, sql);
+        st.prepare();
+        bind(st, typename make_index_list<sizeof...(Params)>::type());
+        while ( st.exec() ) {}
+        return s.last_changes();
+    }
+
+    template<std::size_t... I>
+    void bind(statement& st, index_list<I...>)
+    {
+        int expand[] = { 0, (st.use_value(static_cast<int>(I) + 1,
+            converter<Params>::from(std::get<I>(params)), true), 0)... };
+        (void)expand;
+    }
+};
+
+// Query with parameters, all rows read.
+template<typename Row, typename... Params>
+struct query_operation
+{
+    u8string sql;
+    std::tuple<Params...> params;
+
+    std::vector<Row> operator()(session& s)
+    {
+        return query(s, typename make_index_list<sizeof...(Params)>::type());
+    }
+
+    template<std::size_t... I>
+    std::vector<Row> query(session& s, index_list<I...>)
+    {
+        typed_statement<Row(Params...)> ts(s, sql);
+        return ts.query(std::get<I>(params)...);
+    }
+};
+
+// Function called in transaction, committed after it returns.
+template<typename F>
+struct transaction_operation
+{
+    F f;
+    transaction::type type;
+
+    typedef decltype(std::declval<F&>()(std::declval<session&>())) result_type;
+
+    result_type operator()(session& s)
+    {
+        return call(s, std::is_void<result_type>());
+    }
+
+    result_type call(session& s, std::false_type)
+    {
+        transaction txn(s, type);
+        result_type r = f(s);
+        txn.commit();
+        return r;
+    }
+
+    void call(session& s, std::true_type)
+    {
+        transaction txn(s, type);
+        f(s);
+        txn.commit();
+    }
+};
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Result of an operation of async_session, like std::future.
+// Under C++20 it is awaitable, the coroutine is resumed with the result
+// moved out, by the executor of the session.
+template<typename R>
+class async_result
+{
+public:
+    async_result() noexcept : owner_(nullptr) {}
+
+    // Does the result refer to an operation?
+    bool valid() const noexcept { return state_ != nullptr; }
+
+    // Is operation done?
+    bool ready() const { return state_->ready(); }
+
+    // Wait until operation is done.
+    void wait() const { state_->wait(); }
+
+    // Wait for operation, move its result out or throw its exception.
+    R get()
+    {
+        state_->wait();
+        state_->rethrow();
+        return detail::take(*state_);
+    }
+
+    // Cancel operation: queued operation fails with SQLITE_INTERRUPT,
+    // SQL statement running at the moment is interrupted, later
+    // statements of the operation throw before they step.
+    void cancel();
+
+#ifdef SQLITEPP_HAS_COROUTINES
+    bool await_ready() const { return state_->ready(); }
+
+    bool await_suspend(std::coroutine_handle<> h)
+    {
+        return state_->suspend([h] { h.resume(); });
+    }
+
+    R await_resume() { return get(); }
+#endif
+
+private:
+    friend class async_session;
+
+    async_result(std::shared_ptr<detail::async_value<R>> state, async_session* owner) noexcept
+        : state_(std::move(state))
+        , owner_(owner)
+    {
+    }
+
+    std::shared_ptr<detail::async_value<R>> state_;
+    async_session* owner_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Session owned by a private worker thread, for callers which must not
+// block on database I/O. Noncopyable. Operations are queued and run by the
+// worker in order, taken from the queue in batches. Results are
+// async_result, waited for or awaited by C++20 coroutines:
+//
+//     async_session db("app.db");
+//     auto rows = co_await db.query<int, u8string>("select id, name from t where id > ?", 42);
+//
+// Awaiting coroutines are resumed on the worker thread unless the options
+// have an executor, they must not block there waiting for the session.
+class SQLITEPP_API async_session
+{
+public:
+    struct options
+    {
+        options() noexcept
+            : max_batch(256)
+        {
+        }
+
+        // Maximal number of operations taken from the queue at once.
+        std::size_t max_batch;
+        // Run continuation of awaiting coroutine, e.g. post it to an event loop.
+        // Null runs it on the worker thread. Must not throw.
+        std::function<void (std::function<void()>)> executor;
+        // Tuning applied to the session on open.
+        session_options tuning;
+    };
+
+    // Open session and start worker thread.
+    explicit async_session(text const& filename, options const& opts = options(),
+                           unsigned flags = session::read | session::write | session::create);
+
+    async_session(async_session const&) = delete;
+    async_session& operator=(async_session const&) = delete;
+
+    // Run queued operations and stop.
+    ~async_session();
+
+    // Queue f(session&), could be called from any thread.
+    template<typename F>
+    auto submit(F f) -> async_result<decltype(f(std::declval<session&>()))>
+    {
+        typedef decltype(f(std::declval<session&>())) R;
+        std::shared_ptr<detail::async_value<R>> state =
+            std::make_shared<detail::async_task<F, R>>(std::move(f));
+        push(state);
+        return async_result<R>(std::move(state), this);
+    }
+
+    // Queue statement with parameters, executed until done.
+    // Result is the number of changed rows.
+    template<typename... Params>
+    async_result<std::size_t> exec(u8string sql, Params... params)
+    {
+        detail::exec_operation<Params...> op = { std::move(sql), std::tuple<Params...>(std::move(params)...) };
+        return submit(std::move(op));
+    }
+
+    // Queue query with parameters, result is the vector of all rows
+    // as tuples of Columns, e.g. query<int, u8string>(sql, 42).
+    template<typename... Columns, typename... Params>
+    async_result<std::vector<std::tuple<Columns...>>> query(u8string sql, Params... params)
+    {
+        detail::query_operation<std::tuple<Columns...>, Params...> op =
+            { std::move(sql), std::tuple<Params...>(std::move(params)...) };
+        return submit(std::move(op));
+    }
+
+    // Queue f(session&) called in transaction, committed when f returns,
+    // or rolled back if it throws.
+    template<typename F>
+    auto transaction(F f, sqlitepp::transaction::type type = sqlitepp::transaction::deferred)
+        -> async_result<typename detail::transaction_operation<F>::result_type>
+    {
+        detail::transaction_operation<F> op = { std::move(f), type };
+        return submit(std::move(op));
+    }
+
+    // Cancel all queued operations and the running one.
+    void cancel();
+
+    // Run queued operations and stop worker thread. Later operations throw.
+    void stop();
+
+    // Number of batches taken from the queue.
+    unsigned long long batches() const noexcept;
+
+private:
+    template<typename R> friend class async_result;
+
+    // Enqueue operation.
+    void push(std::shared_ptr<detail::async_state> op);
+    // Cancel queued or running operation.
+    void cancel(detail::async_state& op);
+
+    void run();
+
+    session db_;
+    options const opts_;
+
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+    std::deque<std::shared_ptr<detail::async_state>> queue_;
+    bool stopped_;
+    // Operation run by the worker.
+    detail::async_state* current_;
+
+    std::atomic<unsigned long long> batches_;
+
+    std::thread worker_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+template<typename R>
+inline void async_result<R>::cancel()
+{
+    owner_->cancel(*state_);
+}
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_ASYNC_SESSION_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
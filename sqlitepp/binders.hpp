@@ -9,8 +9,9 @@
 #define SQLITEPP_BINDERS_HPP_INCLUDED
 
 #include <memory>
+#include <type_traits>
 
-#include "fwd.hpp"
+#include "string.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -18,9 +19,25 @@ namespace sqlitepp {
 
 //////////////////////////////////////////////////////////////////////////////
 
+/// Scalar types bound and updated by statement without virtual calls.
+/// Row kinds append values of each row to a column container.
+enum class scalar_kind : unsigned char
+{
+    none, int32, int64, real, string,
+    int32_rows, int64_rows, real_rows, text_rows, blob_rows
+};
+
+template<typename T> struct scalar_kind_of : std::integral_constant<scalar_kind, scalar_kind::none> {};
+template<> struct scalar_kind_of<int> : std::integral_constant<scalar_kind, scalar_kind::int32> {};
+template<> struct scalar_kind_of<long long> : std::integral_constant<scalar_kind, scalar_kind::int64> {};
+template<> struct scalar_kind_of<double> : std::integral_constant<scalar_kind, scalar_kind::real> {};
+template<> struct scalar_kind_of<u8string> : std::integral_constant<scalar_kind, scalar_kind::string> {};
+
 /// into binder interface
 class SQLITEPP_API into_binder
 {
+    friend class statement; // access to scalar
+
 public:
     into_binder() = default;
     virtual ~into_binder() = default;
@@ -32,6 +49,29 @@ public:
 
     // Update bound value.
     virtual void update(statement& st) = 0;
+
+    // Expect to update about rows more times.
+    virtual void reserve(std::size_t rows) { (void)rows; }
+
+protected:
+    // Binders are moved into query.
+    into_binder(into_binder&& src) noexcept : scalar_(src.scalar_) {}
+
+    // Let statement update value of column pos directly.
+    void scalar(scalar_kind kind, void* value, int pos) noexcept
+    {
+        scalar_.kind = kind;
+        scalar_.value = value;
+        scalar_.pos = pos;
+    }
+
+private:
+    struct
+    {
+        scalar_kind kind = scalar_kind::none;
+        void* value = nullptr;
+        int pos = -1;
+    } scalar_;
 };
 
 typedef std::unique_ptr<into_binder> into_binder_ptr;
@@ -39,6 +79,8 @@ typedef std::unique_ptr<into_binder> into_binder_ptr;
 /// use binder interface
 class SQLITEPP_API use_binder
 {
+    friend class statement; // access to scalar
+
 public:
     use_binder() = default;
     virtual ~use_binder() = default;
@@ -47,6 +89,28 @@ public:
 
     /// Bind value to statement st in position pos
     virtual int bind(statement& st, int pos) = 0;
+
+protected:
+    // Binders are moved into query.
+    use_binder(use_binder&& src) noexcept : scalar_(src.scalar_) {}
+
+    // Let statement bind value directly, in position pos if pos > 0.
+    void scalar(scalar_kind kind, void const* value, int pos, bool copy) noexcept
+    {
+        scalar_.kind = kind;
+        scalar_.value = value;
+        scalar_.pos = pos;
+        scalar_.copy = copy;
+    }
+
+private:
+    struct
+    {
+        scalar_kind kind = scalar_kind::none;
+        void const* value = nullptr;
+        int pos = -1;
+        bool copy = false;
+    } scalar_;
 };
 
 typedef std::unique_ptr<use_binder> use_binder_ptr;
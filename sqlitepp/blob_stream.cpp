@@ -0,0 +1,244 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <algorithm>
+#include <cstring>
+
+#include <sqlite3.h>
+
+#include "blob_stream.hpp"
+#include "exception.hpp"
+#include "session.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+blob_stream::blob_stream(session& s, text const& table, text const& column, long long row,
+        bool writable, std::size_t buffer_size, text const& db)
+    : s_(s)
+    , impl_(nullptr)
+    , size_(0)
+    , writable_(writable)
+    , base_(0)
+    , buf_(buffer_size ? buffer_size : 1)
+{
+    int const r = sqlite3_blob_open(s_.impl(), db.data, table.data, column.data,
+        row, writable ? 1 : 0, &impl_);
+    if ( r != SQLITE_OK )
+    {
+        // handle is set to null on error
+        s_.check_error(r);
+    }
+    size_ = sqlite3_blob_bytes(impl_);
+}
+//----------------------------------------------------------------------------
+
+blob_stream::~blob_stream()
+{
+    flush();
+    sqlite3_blob_close(impl_);
+}
+//----------------------------------------------------------------------------
+
+void blob_stream::reopen(long long row)
+{
+    if ( !flush() )
+    {
+        throw exception(sqlite3_errcode(s_.impl()), sqlite3_errmsg(s_.impl()));
+    }
+    base_ = 0;
+    size_ = 0;
+    s_.check_error( sqlite3_blob_reopen(impl_, row) );
+    size_ = sqlite3_blob_bytes(impl_);
+}
+//----------------------------------------------------------------------------
+
+void blob_stream::close()
+{
+    bool const flushed = flush();
+    int const r = sqlite3_blob_close(impl_);
+    impl_ = nullptr;
+    size_ = 0;
+    base_ = 0;
+    if ( !flushed )
+    {
+        throw exception(sqlite3_errcode(s_.impl()), sqlite3_errmsg(s_.impl()));
+    }
+    s_.check_error(r);
+}
+//----------------------------------------------------------------------------
+
+bool blob_stream::is_open() const noexcept
+{
+    return impl_ != nullptr;
+}
+//----------------------------------------------------------------------------
+
+std::size_t blob_stream::size() const noexcept
+{
+    return size_;
+}
+//----------------------------------------------------------------------------
+
+sqlite3_blob* blob_stream::impl() const noexcept
+{
+    return impl_;
+}
+//----------------------------------------------------------------------------
+
+std::size_t blob_stream::read(std::size_t offset, void* data, std::size_t size)
+{
+    if ( offset >= size_ )
+    {
+        return 0;
+    }
+    size = std::min(size, size_ - offset);
+    s_.check_error( sqlite3_blob_read(impl_, data, static_cast<int>(size), static_cast<int>(offset)) );
+    return size;
+}
+//----------------------------------------------------------------------------
+
+void blob_stream::write(std::size_t offset, void const* data, std::size_t size)
+{
+    if ( offset > size_ || size > size_ - offset )
+    {
+        throw exception(SQLITE_RANGE, sqlite3_errstr(SQLITE_RANGE));
+    }
+    s_.check_error( sqlite3_blob_write(impl_, data, static_cast<int>(size), static_cast<int>(offset)) );
+}
+//----------------------------------------------------------------------------
+
+std::size_t blob_stream::position() const noexcept
+{
+    if ( gptr() ) return base_ + (gptr() - eback());
+    if ( pptr() ) return base_ + (pptr() - pbase());
+    return base_;
+}
+//----------------------------------------------------------------------------
+
+bool blob_stream::flush() noexcept
+{
+    std::size_t const pos = position();
+    int r = SQLITE_OK;
+    if ( pptr() && pptr() != pbase() )
+    {
+        r = sqlite3_blob_write(impl_, pbase(), static_cast<int>(pptr() - pbase()), static_cast<int>(base_));
+    }
+    setg(nullptr, nullptr, nullptr);
+    setp(nullptr, nullptr);
+    base_ = pos;
+    return r == SQLITE_OK;
+}
+//----------------------------------------------------------------------------
+
+blob_stream::int_type blob_stream::underflow()
+{
+    if ( gptr() && gptr() < egptr() )
+    {
+        return traits_type::to_int_type(*gptr());
+    }
+    if ( !flush() || !impl_ || base_ >= size_ )
+    {
+        return traits_type::eof();
+    }
+
+    std::size_t const n = std::min(buf_.size(), size_ - base_);
+    if ( sqlite3_blob_read(impl_, buf_.data(), static_cast<int>(n), static_cast<int>(base_)) != SQLITE_OK )
+    {
+        return traits_type::eof();
+    }
+    setg(buf_.data(), buf_.data(), buf_.data() + n);
+    return traits_type::to_int_type(*gptr());
+}
+//----------------------------------------------------------------------------
+
+blob_stream::int_type blob_stream::overflow(int_type c)
+{
+    // full put area, or switch from reading to writing
+    if ( !flush() || !impl_ || !writable_ || base_ >= size_ )
+    {
+        return traits_type::eof();
+    }
+
+    // put area ends at BLOB end, the size can't grow
+    std::size_t const n = std::min(buf_.size(), size_ - base_);
+    setp(buf_.data(), buf_.data() + n);
+    if ( !traits_type::eq_int_type(c, traits_type::eof()) )
+    {
+        *pptr() = traits_type::to_char_type(c);
+        pbump(1);
+    }
+    return traits_type::not_eof(c);
+}
+//----------------------------------------------------------------------------
+
+int blob_stream::sync()
+{
+    return flush() ? 0 : -1;
+}
+//----------------------------------------------------------------------------
+
+std::streamsize blob_stream::xsgetn(char_type* s, std::streamsize n)
+{
+    std::streamsize done = 0;
+    if ( gptr() )
+    {
+        // buffered part first
+        done = std::min<std::streamsize>(n, egptr() - gptr());
+        std::memcpy(s, gptr(), static_cast<std::size_t>(done));
+        gbump(static_cast<int>(done));
+    }
+    if ( done < n && static_cast<std::size_t>(n - done) >= buf_.size() )
+    {
+        // large reads bypass the buffer
+        if ( !flush() || !impl_ )
+        {
+            return done;
+        }
+        std::size_t const count = std::min(static_cast<std::size_t>(n - done), size_ - base_);
+        if ( sqlite3_blob_read(impl_, s + done, static_cast<int>(count), static_cast<int>(base_)) != SQLITE_OK )
+        {
+            return done;
+        }
+        base_ += count;
+        return done + static_cast<std::streamsize>(count);
+    }
+    return done + std::streambuf::xsgetn(s + done, n - done);
+}
+//----------------------------------------------------------------------------
+
+blob_stream::pos_type blob_stream::seekoff(off_type off, std::ios_base::seekdir dir,
+        std::ios_base::openmode)
+{
+    off_type from = 0;
+    if ( dir == std::ios_base::cur ) from = static_cast<off_type>(position());
+    else if ( dir == std::ios_base::end ) from = static_cast<off_type>(size_);
+
+    off_type const pos = from + off;
+    if ( pos < 0 || pos > static_cast<off_type>(size_) || !flush() )
+    {
+        return pos_type(off_type(-1));
+    }
+    base_ = static_cast<std::size_t>(pos);
+    return pos_type(pos);
+}
+//----------------------------------------------------------------------------
+
+blob_stream::pos_type blob_stream::seekpos(pos_type pos, std::ios_base::openmode which)
+{
+    return seekoff(off_type(pos), std::ios_base::beg, which);
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,103 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_BLOB_STREAM_HPP_INCLUDED
+#define SQLITEPP_BLOB_STREAM_HPP_INCLUDED
+
+#include <streambuf>
+#include <vector>
+
+#include "string.hpp"
+
+struct sqlite3_blob;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+class session;
+
+// Incremental I/O of a BLOB value, without loading it whole. Noncopyable.
+// Use as std::streambuf of std::istream or std::ostream, or read and write
+// chunks at offsets. The BLOB size can't be changed, so make room for
+// written data first, e.g. insert zeroblob with use(blob{nullptr, size}).
+//
+//     blob_stream bs(s, "files", "content", rowid);
+//     std::istream in(&bs);
+//
+class SQLITEPP_API blob_stream : public std::streambuf
+{
+public:
+    // Open BLOB in column of table row, with buffer of buffer_size bytes.
+    blob_stream(session& s, text const& table, text const& column, long long row,
+        bool writable = false, std::size_t buffer_size = 64 * 1024, text const& db = "main");
+
+    blob_stream(blob_stream const&) = delete;
+    blob_stream& operator=(blob_stream const&) = delete;
+
+    // Write buffered data and close BLOB, errors are ignored.
+    ~blob_stream();
+
+    // Write buffered data and move to BLOB in the same column of another row.
+    // Position is reset to the beginning.
+    void reopen(long long row);
+
+    // Write buffered data and close BLOB.
+    void close();
+
+    // Is BLOB open?
+    bool is_open() const noexcept;
+
+    // BLOB size in bytes.
+    std::size_t size() const noexcept;
+
+    // Read up to size bytes at offset. Return number of bytes read,
+    // less than size at the end of BLOB.
+    std::size_t read(std::size_t offset, void* data, std::size_t size);
+
+    // Write size bytes at offset, throw if they don't fit into BLOB.
+    void write(std::size_t offset, void const* data, std::size_t size);
+
+    /// SQLite BLOB handle for sqlite3_blob functions.
+    sqlite3_blob* impl() const noexcept;
+
+protected:
+    int_type underflow() override;
+    int_type overflow(int_type c) override;
+    int sync() override;
+    std::streamsize xsgetn(char_type* s, std::streamsize n) override;
+    pos_type seekoff(off_type off, std::ios_base::seekdir dir,
+        std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override;
+    pos_type seekpos(pos_type pos,
+        std::ios_base::openmode which = std::ios_base::in | std::ios_base::out) override;
+
+private:
+    // Current stream position in BLOB.
+    std::size_t position() const noexcept;
+    // Write put area, drop get and put areas, keep position.
+    bool flush() noexcept;
+
+    session& s_;
+    sqlite3_blob* impl_;
+    std::size_t size_;
+    bool writable_;
+    // BLOB offset of buffer beginning.
+    std::size_t base_;
+    std::vector<char> buf_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_BLOB_STREAM_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,460 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cctype>
+#include <cstring>
+
+#include <sqlite3.h>
+
+#include "bulk_insert.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Position after quoted literal or identifier, or comment at i, or i itself.
+std::size_t skip_quoted(std::string const& s, std::size_t i)
+{
+    char const c = s[i];
+    if ( c == '-' && s.compare(i, 2, "--") == 0 )
+    {
+        std::size_t const end = s.find('\n', i);
+        return end == std::string::npos ? s.size() : end + 1;
+    }
+    if ( c == '/' && s.compare(i, 2, "/*") == 0 )
+    {
+        std::size_t const end = s.find("*/", i + 2);
+        return end == std::string::npos ? s.size() : end + 2;
+    }
+    if ( c != '\'' && c != '"' && c != '`' && c != '[' )
+    {
+        return i;
+    }
+
+    char const close = (c == '[') ? ']' : c;
+    for (++i; i < s.size(); ++i)
+    {
+        if ( s[i] == close )
+        {
+            // doubled quote is escaped
+            if ( close != ']' && i + 1 < s.size() && s[i + 1] == close )
+            {
+                ++i;
+                continue;
+            }
+            return i + 1;
+        }
+    }
+    return s.size();
+}
+//----------------------------------------------------------------------------
+
+inline bool is_word(char c)
+{
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+}
+//----------------------------------------------------------------------------
+
+// Is there the VALUES keyword at i?
+bool is_values(std::string const& s, std::size_t i)
+{
+    static char const keyword[] = "values";
+    std::size_t const n = sizeof(keyword) - 1;
+    if ( s.size() - i < n || (i > 0 && is_word(s[i - 1])) || (i + n < s.size() && is_word(s[i + n])) )
+    {
+        return false;
+    }
+    for (std::size_t k = 0; k < n; ++k)
+    {
+        if ( std::tolower(static_cast<unsigned char>(s[i + k])) != keyword[k] ) return false;
+    }
+    return true;
+}
+//----------------------------------------------------------------------------
+
+// Split sql into text before, of and after its only VALUES row,
+// which must have all params of the statement as anonymous parameters.
+bool split_values(std::string const& sql, int params,
+    std::string& head, std::string& row, std::string& tail)
+{
+    std::size_t begin = std::string::npos;
+    int depth = 0;
+    for (std::size_t i = 0; i < sql.size(); )
+    {
+        std::size_t const next = skip_quoted(sql, i);
+        if ( next != i )
+        {
+            i = next;
+            continue;
+        }
+        if ( sql[i] == '(' ) ++depth;
+        else if ( sql[i] == ')' ) --depth;
+        else if ( depth == 0 && is_values(sql, i) )
+        {
+            if ( begin != std::string::npos )
+            {
+                return false;
+            }
+            begin = i + 6;
+        }
+        ++i;
+    }
+    if ( begin == std::string::npos )
+    {
+        return false;
+    }
+
+    while ( begin < sql.size() && std::isspace(static_cast<unsigned char>(sql[begin])) ) ++begin;
+    std::size_t end = std::string::npos;
+    int count = 0;
+    depth = 0;
+    for (std::size_t i = begin; i < sql.size() && end == std::string::npos; )
+    {
+        std::size_t const next = skip_quoted(sql, i);
+        if ( next != i )
+        {
+            i = next;
+            continue;
+        }
+        switch ( sql[i] )
+        {
+        case '(':
+            ++depth;
+            break;
+        case ')':
+            if ( --depth == 0 ) end = i + 1;
+            break;
+        case '?':
+            // ?NNN could be repeated in other rows
+            if ( i + 1 < sql.size() && std::isdigit(static_cast<unsigned char>(sql[i + 1])) ) return false;
+            ++count;
+            break;
+        case ':': case '@': case '$':
+            // named parameter
+            return false;
+        }
+        if ( i == begin && depth != 1 )
+        {
+            return false;
+        }
+        ++i;
+    }
+    if ( end == std::string::npos || count != params )
+    {
+        return false;
+    }
+    std::size_t next = end;
+    while ( next < sql.size() && std::isspace(static_cast<unsigned char>(sql[next])) ) ++next;
+    if ( next < sql.size() && sql[next] == ',' )
+    {
+        // multi-row already
+        return false;
+    }
+
+    head.assign(sql, 0, begin);
+    row.assign(sql, begin, end - begin);
+    tail.assign(sql, end, std::string::npos);
+    return true;
+}
+//----------------------------------------------------------------------------
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////////
+
+bulk_insert::bulk_insert(session& s, text const& sql, options const& opts)
+    : s_(s)
+    , st_(s, sql)
+    , opts_(opts)
+    , pos_(0)
+    , batch_(1)
+    , pending_(0)
+    , multi_(s)
+    , chunk_rows_(0)
+    , rows_(0)
+    , chunks_(0)
+{
+    st_.prepare();
+    params_ = st_.use_count();
+    prepare_batch(opts.batch_rows);
+}
+//----------------------------------------------------------------------------
+
+bulk_insert::~bulk_insert() = default;
+//----------------------------------------------------------------------------
+
+void bulk_insert::begin_row(int count)
+{
+    if ( count != params_ )
+    {
+        throw std::invalid_argument("bulk_insert value count mismatch");
+    }
+    if ( !txn_ )
+    {
+        if ( rows_ == 0 )
+        {
+            start_ = std::chrono::steady_clock::now();
+        }
+        // continue after finish
+        stop_ = std::chrono::steady_clock::time_point();
+        txn_.reset(new transaction(s_, opts_.txn_type));
+    }
+    if ( batch_ == 1 && !st_.is_prepared() )
+    {
+        // finalized by failed row
+        st_.prepare();
+    }
+    pos_ = pending_ * params_;
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::end_row()
+{
+    if ( batch_ > 1 )
+    {
+        if ( ++pending_ == batch_ )
+        {
+            pending_ = 0;
+            exec_batch(multi_, batch_);
+        }
+    }
+    else
+    {
+        st_.exec();
+        st_.reset();
+        ++rows_;
+    }
+
+    if ( opts_.chunk_size && ++chunk_rows_ >= opts_.chunk_size )
+    {
+        commit();
+    }
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::prepare_batch(std::size_t batch_rows)
+{
+    if ( batch_rows == 1 || params_ == 0 || !split_values(st_.q().sql(), params_, head_, row_, tail_) )
+    {
+        return;
+    }
+
+    std::size_t const limit = sqlite3_limit(s_.impl(), SQLITE_LIMIT_VARIABLE_NUMBER, -1) / params_;
+    if ( batch_rows == 0 || batch_rows > limit )
+    {
+        batch_rows = limit;
+    }
+    if ( opts_.chunk_size && batch_rows > opts_.chunk_size )
+    {
+        // batch would never be full, chunk commit inserts the tail
+        batch_rows = opts_.chunk_size;
+    }
+    if ( batch_rows > 1 )
+    {
+        multi_ << batch_sql(batch_rows);
+        multi_.prepare();
+        cells_.resize(batch_rows * params_);
+        batch_ = batch_rows;
+    }
+}
+//----------------------------------------------------------------------------
+
+std::string bulk_insert::batch_sql(std::size_t rows) const
+{
+    std::string sql;
+    sql.reserve(head_.size() + rows * (row_.size() + 2) + tail_.size());
+    sql += head_;
+    sql += row_;
+    for (std::size_t i = 1; i < rows; ++i)
+    {
+        sql += ", ";
+        sql += row_;
+    }
+    sql += tail_;
+    return sql;
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::exec_batch(statement& st, std::size_t rows)
+{
+    if ( !st.is_prepared() )
+    {
+        // finalized by failed batch
+        st.prepare();
+    }
+    for (std::size_t i = 0, n = rows * params_; i < n; ++i)
+    {
+        cell const& c = cells_[i];
+        int const pos = static_cast<int>(i) + 1;
+        switch ( c.kind )
+        {
+        case cell::null_value:
+            st.use_value(pos, nullptr);
+            break;
+        case cell::int_value:
+            st.use_value(pos, c.i);
+            break;
+        case cell::real_value:
+            st.use_value(pos, c.r);
+            break;
+        case cell::text_value:
+            st.use_value(pos, text(c.bytes.data(), c.bytes.size()));
+            break;
+        case cell::blob_value:
+            {
+                blob const b = { c.bytes.data(), c.bytes.size() };
+                st.use_value(pos, b);
+            }
+            break;
+        case cell::text16_value:
+            st.use_value(pos, text16(reinterpret_cast<char16_t const*>(c.bytes.data()), c.bytes.size() / 2));
+            break;
+        case cell::zeroblob_value:
+            {
+                blob const b = { nullptr, static_cast<std::size_t>(c.i) };
+                st.use_value(pos, b);
+            }
+            break;
+        }
+    }
+    st.exec();
+    st.reset();
+    rows_ += rows;
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::flush()
+{
+    if ( pending_ )
+    {
+        std::size_t const rows = pending_;
+        pending_ = 0;
+        statement tail(s_, batch_sql(rows));
+        tail.prepare();
+        exec_batch(tail, rows);
+    }
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::commit()
+{
+    flush();
+    txn_->commit();
+    txn_.reset();
+    chunk_rows_ = 0;
+    ++chunks_;
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::store(std::size_t pos, std::nullptr_t)
+{
+    cells_[pos].kind = cell::null_value;
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::store(std::size_t pos, int value)
+{
+    store(pos, static_cast<long long>(value));
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::store(std::size_t pos, long long value)
+{
+    cells_[pos].kind = cell::int_value;
+    cells_[pos].i = value;
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::store(std::size_t pos, double value)
+{
+    cells_[pos].kind = cell::real_value;
+    cells_[pos].r = value;
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::store(std::size_t pos, text const& value)
+{
+    if ( !value.data )
+    {
+        return store(pos, nullptr);
+    }
+    cells_[pos].kind = cell::text_value;
+    cells_[pos].bytes.assign(value.data,
+        value.size != std::size_t(-1) ? value.size : std::strlen(value.data));
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::store(std::size_t pos, blob const& value)
+{
+    if ( !value.data )
+    {
+        // bound as zeroblob of size bytes, as by statement::use_value
+        if ( value.size > 0 )
+        {
+            cells_[pos].kind = cell::zeroblob_value;
+            cells_[pos].i = static_cast<long long>(value.size);
+            return;
+        }
+        return store(pos, nullptr);
+    }
+    cells_[pos].kind = cell::blob_value;
+    cells_[pos].bytes.assign(static_cast<char const*>(value.data), value.size);
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::store(std::size_t pos, text16 const& value)
+{
+    if ( !value.data )
+    {
+        return store(pos, nullptr);
+    }
+    std::size_t const size = value.size != std::size_t(-1)
+        ? value.size : std::char_traits<char16_t>::length(value.data);
+    cells_[pos].kind = cell::text16_value;
+    cells_[pos].bytes.assign(reinterpret_cast<char const*>(value.data), size * 2);
+}
+//----------------------------------------------------------------------------
+
+void bulk_insert::finish()
+{
+    if ( txn_ )
+    {
+        commit();
+    }
+    if ( rows_ )
+    {
+        stop_ = std::chrono::steady_clock::now();
+    }
+}
+//----------------------------------------------------------------------------
+
+bulk_insert::stats bulk_insert::statistics() const
+{
+    stats st;
+    st.rows = rows_;
+    st.chunks = chunks_;
+    st.elapsed = std::chrono::nanoseconds(0);
+    if ( rows_ )
+    {
+        bool const finished = stop_ != std::chrono::steady_clock::time_point();
+        st.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            (finished ? stop_ : std::chrono::steady_clock::now()) - start_);
+    }
+    st.rows_per_second = st.elapsed.count() ? rows_ * 1e9 / st.elapsed.count() : 0.0;
+    return st;
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
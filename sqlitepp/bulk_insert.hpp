@@ -0,0 +1,240 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_BULK_INSERT_HPP_INCLUDED
+#define SQLITEPP_BULK_INSERT_HPP_INCLUDED
+
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "session.hpp"
+#include "statement.hpp"
+#include "transaction.hpp"
+#include "typed_statement.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Insert of many rows with one prepared statement. Noncopyable.
+// Row values are bound directly with converter<T>, without binders.
+// Rows are committed in chunks, each chunk in its own transaction
+// (a nested one if the session already has an active transaction).
+//
+// Optionally INSERT ... VALUES(?, ...) is rewritten to insert a batch of
+// rows with one multi-row VALUES statement. Row values are buffered until
+// the batch is full, the rest is inserted by a tail statement on chunk
+// commit or finish. A failed batch statement inserts none of its rows.
+//
+// A failed row or batch throws and is not inserted. Rows inserted before
+// stay in the open chunk transaction, inserting could go on, and finish
+// commits them. Destroy bulk_insert without finish to roll them back.
+//
+//     bulk_insert bi(s, "insert into t values(?, ?)");
+//     bi.insert_columns(ids, names);
+//     bi.finish();
+//
+class SQLITEPP_API bulk_insert
+{
+public:
+    struct options
+    {
+        options() noexcept
+            : chunk_size(10000)
+            , batch_rows(1)
+            , txn_type(transaction::immediate)
+        {
+        }
+
+        // Number of rows committed in one transaction, 0 commits only on finish.
+        std::size_t chunk_size;
+        // Number of rows in one multi-row VALUES statement, 1 disables batching.
+        // 0 and large numbers are limited by SQLITE_LIMIT_VARIABLE_NUMBER
+        // and chunk_size. Chunk size should be a multiple of batch rows.
+        // Batching is disabled for statements with other than one VALUES row
+        // of anonymous ? parameters.
+        std::size_t batch_rows;
+        // Type of chunk transaction.
+        transaction::type txn_type;
+    };
+
+    // Insert progress.
+    struct stats
+    {
+        // Number of executed rows, committed or not. Buffered rows of
+        // an incomplete batch are not counted.
+        unsigned long long rows;
+        // Number of committed chunks.
+        unsigned long long chunks;
+        // Time since the first row until now, or until finish.
+        std::chrono::nanoseconds elapsed;
+        // Inserted rows per second of elapsed time.
+        double rows_per_second;
+    };
+
+    // Prepare single row insert statement.
+    bulk_insert(session& s, text const& sql, options const& opts = options());
+
+    bulk_insert(bulk_insert const&) = delete;
+    bulk_insert& operator=(bulk_insert const&) = delete;
+
+    // Roll back rows not committed with finish.
+    ~bulk_insert();
+
+    // Insert row of values.
+    template<typename... T>
+    void insert(T const&... values)
+    {
+        begin_row(sizeof...(T));
+        int expand[] = { 0, (bind_value(values), 0)... };
+        (void)expand;
+        end_row();
+    }
+
+    // Insert row of tuple values.
+    template<typename... T>
+    void insert(std::tuple<T...> const& row)
+    {
+        insert_tuple(row, typename detail::make_index_list<sizeof...(T)>::type());
+    }
+
+    // Insert range of tuples.
+    template<typename Range>
+    void insert_rows(Range const& rows)
+    {
+        for (auto const& row : rows) insert(row);
+    }
+
+    // Insert range of structs, f(row) returns tuple of values, e.g. std::tie(row.id, row.name).
+    template<typename Range, typename F>
+    void insert_rows(Range const& rows, F f)
+    {
+        for (auto const& row : rows) insert(f(row));
+    }
+
+    // Insert columns of equal size, one container per statement parameter.
+    template<typename... T>
+    void insert_columns(std::vector<T> const&... columns)
+    {
+        std::size_t const sizes[] = { columns.size()... };
+        for (std::size_t size : sizes)
+        {
+            if ( size != sizes[0] )
+            {
+                throw std::invalid_argument("bulk_insert columns differ in size");
+            }
+        }
+        for (std::size_t i = 0; i < sizes[0]; ++i)
+        {
+            insert(static_cast<T const&>(columns[i])...);
+        }
+    }
+
+    // Commit inserted rows.
+    void finish();
+
+    // Insert progress.
+    stats statistics() const;
+
+    // Number of rows inserted by one statement execution.
+    std::size_t batch_rows() const noexcept { return batch_; }
+
+    // Underlying insert statement.
+    statement& st() noexcept { return st_; }
+
+private:
+    template<typename... T, std::size_t... I>
+    void insert_tuple(std::tuple<T...> const& row, detail::index_list<I...>)
+    {
+        insert(std::get<I>(row)...);
+    }
+
+    template<typename T>
+    void bind_value(T const& value)
+    {
+        if ( batch_ > 1 )
+        {
+            store(pos_++, converter<typename std::decay<T>::type>::from(value));
+        }
+        else
+        {
+            // values live until the row is executed, SQLite needs no copy
+            st_.use_value(++pos_, converter<typename std::decay<T>::type>::from(value), false);
+        }
+    }
+
+    // Buffered value of a batch row.
+    struct cell
+    {
+        enum kind_t { null_value, int_value, real_value, text_value, blob_value, text16_value, zeroblob_value };
+        kind_t kind;
+        // integer value, or size of zeroblob
+        long long i;
+        double r;
+        std::string bytes;
+    };
+
+    void store(std::size_t pos, std::nullptr_t);
+    void store(std::size_t pos, int value);
+    void store(std::size_t pos, long long value);
+    void store(std::size_t pos, double value);
+    void store(std::size_t pos, text const& value);
+    void store(std::size_t pos, blob const& value);
+    void store(std::size_t pos, text16 const& value);
+
+    // Check value count, begin chunk transaction.
+    void begin_row(int count);
+    // Execute bound row or full batch, commit chunk.
+    void end_row();
+    // Rewrite statement to insert batch of rows.
+    void prepare_batch(std::size_t batch_rows);
+    // Multi-row VALUES statement text.
+    std::string batch_sql(std::size_t rows) const;
+    // Bind buffered rows to st and execute it.
+    void exec_batch(statement& st, std::size_t rows);
+    // Insert buffered rows of incomplete batch.
+    void flush();
+    // Commit chunk transaction.
+    void commit();
+
+    session& s_;
+    statement st_;
+    options const opts_;
+    int params_;
+    std::size_t pos_;
+    // Rows per batch statement, 1 without batching.
+    std::size_t batch_;
+    // Buffered rows of current batch.
+    std::size_t pending_;
+    std::vector<cell> cells_;
+    statement multi_;
+    // Statement text before, of and after the VALUES row.
+    std::string head_, row_, tail_;
+    std::unique_ptr<transaction> txn_;
+    std::size_t chunk_rows_;
+    unsigned long long rows_;
+    unsigned long long chunks_;
+    std::chrono::steady_clock::time_point start_;
+    std::chrono::steady_clock::time_point stop_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_BULK_INSERT_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
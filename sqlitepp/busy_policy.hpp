@@ -0,0 +1,87 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_BUSY_POLICY_HPP_INCLUDED
+#define SQLITEPP_BUSY_POLICY_HPP_INCLUDED
+
+#include <array>
+#include <chrono>
+
+#include "fwd.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Waiting for a database locked by another connection, see session::set_busy_policy.
+// Delays grow exponentially from initial_delay up to max_delay, shortened by
+// a random jitter, until the lock is acquired or max_wait passed.
+struct SQLITEPP_API busy_policy
+{
+    busy_policy() noexcept
+        : initial_delay(std::chrono::milliseconds(1))
+        , max_delay(std::chrono::milliseconds(50))
+        , max_wait(std::chrono::seconds(5))
+        , multiplier(2.0)
+        , jitter(0.5)
+        , txn_retries(3)
+    {
+    }
+
+    // Fixed delays until timeout, similar to sqlite3_busy_timeout.
+    static busy_policy timeout(std::chrono::milliseconds ms) noexcept
+    {
+        busy_policy p;
+        p.max_wait = ms;
+        p.multiplier = 1.0;
+        p.jitter = 0.0;
+        return p;
+    }
+
+    std::chrono::microseconds initial_delay;
+    std::chrono::microseconds max_delay;
+    // Total wait of one busy event, SQLITE_BUSY is reported then.
+    std::chrono::milliseconds max_wait;
+    // Delay growth factor.
+    double multiplier;
+    // Maximal random fraction subtracted from each delay, 0 disables jitter.
+    double jitter;
+    // Retries of transaction begin and commit still busy after max_wait.
+    // Both are safe to repeat, a busy commit keeps the transaction active.
+    unsigned txn_retries;
+};
+
+// Busy wait statistics of a session.
+struct SQLITEPP_API busy_stats
+{
+    static std::size_t const buckets = 16;
+
+    // Number of busy events, each with one or more waits.
+    unsigned long long events;
+    // Number of events reported as SQLITE_BUSY after max_wait.
+    unsigned long long timeouts;
+    // Number of transaction begin and commit retries.
+    unsigned long long txn_retries;
+    // Total and maximal wait of an event.
+    std::chrono::nanoseconds total_wait;
+    std::chrono::nanoseconds max_wait;
+    // Events by wait time: histogram[i] waited less than 2^i ms,
+    // the last bucket counts longer waits.
+    std::array<unsigned long long, buckets> histogram;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_BUSY_POLICY_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
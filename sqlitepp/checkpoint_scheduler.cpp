@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstring>
+
+#include <sqlite3.h>
+
+#include "checkpoint_scheduler.hpp"
+#include "into.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+checkpoint_scheduler::checkpoint_scheduler(session& writer, text const& filename, options const& opts)
+    : writer_(writer)
+    , conn_(filename, session::read | session::write)
+    , opts_(opts)
+    , stop_(false)
+    , requested_(-1)
+    , backfilled_(0)
+    , pending_(0)
+    , due_(false)
+    , autocheckpoint_(0)
+    , stats_()
+{
+    conn_.set_busy_policy(busy_policy::timeout(opts_.busy_timeout));
+    // a connection opens the WAL on its first read, checkpoints do nothing before
+    conn_ << "select count(*) from sqlite_master";
+    // zero if automatic checkpoints are disabled or replaced with other hook
+    writer_ << "pragma wal_autocheckpoint", into(autocheckpoint_);
+    // replaces the automatic checkpoint hook
+    sqlite3_wal_hook(writer_.impl(), on_commit, this);
+    worker_ = std::thread(&checkpoint_scheduler::run, this);
+}
+//----------------------------------------------------------------------------
+
+checkpoint_scheduler::~checkpoint_scheduler()
+{
+    sqlite3_wal_hook(writer_.impl(), nullptr, nullptr);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stop_ = true;
+    }
+    wakeup_.notify_one();
+    worker_.join();
+    sqlite3_wal_autocheckpoint(writer_.impl(), autocheckpoint_);
+}
+//----------------------------------------------------------------------------
+
+void checkpoint_scheduler::request(mode m)
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requested_ = m;
+    }
+    wakeup_.notify_one();
+}
+//----------------------------------------------------------------------------
+
+checkpoint_scheduler::stats checkpoint_scheduler::statistics() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+//----------------------------------------------------------------------------
+
+int checkpoint_scheduler::on_commit(void* self, sqlite3*, char const* name, int pages)
+{
+    checkpoint_scheduler& cs = *static_cast<checkpoint_scheduler*>(self);
+    if ( std::strcmp(name, "main") != 0 )
+    {
+        return SQLITE_OK;
+    }
+
+    std::size_t const size = static_cast<std::size_t>(pages);
+    bool notify;
+    {
+        std::lock_guard<std::mutex> lock(cs.mutex_);
+        cs.stats_.wal_pages = size;
+        if ( size > cs.stats_.max_wal_pages ) cs.stats_.max_wal_pages = size;
+        // smaller WAL was restarted after a complete checkpoint
+        if ( size < cs.backfilled_ ) cs.backfilled_ = 0;
+        cs.pending_ = size - cs.backfilled_;
+        notify = cs.pending_ >= cs.opts_.wal_pages;
+        if ( notify ) cs.due_ = true;
+    }
+    if ( notify )
+    {
+        cs.wakeup_.notify_one();
+    }
+    return SQLITE_OK;
+}
+//----------------------------------------------------------------------------
+
+void checkpoint_scheduler::run()
+{
+    static int const modes[] =
+    {
+        SQLITE_CHECKPOINT_PASSIVE,
+        SQLITE_CHECKPOINT_FULL,
+        SQLITE_CHECKPOINT_RESTART,
+        SQLITE_CHECKPOINT_TRUNCATE,
+    };
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    for (;;)
+    {
+        auto const ready = [this]
+        {
+            return stop_ || requested_ >= 0 || due_;
+        };
+        if ( opts_.interval > std::chrono::milliseconds::zero() )
+        {
+            // timeout checkpoints any non-empty WAL
+            wakeup_.wait_for(lock, opts_.interval, ready);
+        }
+        else
+        {
+            wakeup_.wait(lock, ready);
+        }
+        if ( stop_ )
+        {
+            break;
+        }
+        if ( requested_ < 0 && pending_ == 0 )
+        {
+            continue;
+        }
+
+        mode m = stats_.wal_pages >= opts_.large_wal_pages ? opts_.large_wal_mode : opts_.checkpoint_mode;
+        if ( requested_ >= 0 )
+        {
+            m = static_cast<mode>(requested_);
+        }
+        requested_ = -1;
+        due_ = false;
+        lock.unlock();
+
+        int log = 0, checkpointed = 0;
+        auto const start = std::chrono::steady_clock::now();
+        int const r = sqlite3_wal_checkpoint_v2(conn_.impl(), "main", modes[m], &log, &checkpointed);
+        std::chrono::nanoseconds const duration = std::chrono::steady_clock::now() - start;
+
+        lock.lock();
+        ++stats_.checkpoints;
+        if ( r != SQLITE_OK || checkpointed < log ) ++stats_.incomplete;
+        stats_.last_log_frames = log;
+        stats_.last_checkpointed_frames = checkpointed;
+        stats_.last_error = r;
+        if ( checkpointed > 0 ) backfilled_ = static_cast<std::size_t>(checkpointed);
+        // pages not checkpointed stay pending, periodic checkpoint retries them
+        pending_ = stats_.wal_pages > backfilled_ ? stats_.wal_pages - backfilled_ : 0;
+        stats_.last_duration = duration;
+        stats_.total_duration += duration;
+        if ( duration > stats_.max_duration ) stats_.max_duration = duration;
+    }
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,140 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_CHECKPOINT_SCHEDULER_HPP_INCLUDED
+#define SQLITEPP_CHECKPOINT_SCHEDULER_HPP_INCLUDED
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "session.hpp"
+
+struct sqlite3;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// WAL checkpoints off the write path. Noncopyable.
+// Automatic checkpoints of the writer session are replaced with a WAL hook
+// that only records the WAL size. Checkpoints run in a worker thread on its
+// own connection, when the WAL grows over a threshold or periodically.
+// Restart and truncate checkpoints hold the write lock for a moment,
+// so the writer session should have a busy policy.
+//
+//     session writer("app.db", session_options::oltp_wal());
+//     writer.set_busy_policy(busy_policy());
+//     checkpoint_scheduler cs(writer, "app.db");
+//
+class SQLITEPP_API checkpoint_scheduler
+{
+public:
+    // Checkpoint mode, see sqlite3_wal_checkpoint_v2.
+    enum mode { passive, full, restart, truncate };
+
+    struct options
+    {
+        options() noexcept
+            : wal_pages(1000)
+            , checkpoint_mode(passive)
+            , large_wal_pages(10000)
+            , large_wal_mode(restart)
+            , interval(std::chrono::seconds(1))
+            , busy_timeout(std::chrono::milliseconds(100))
+        {
+        }
+
+        // Pages written to WAL since the last checkpoint, triggering checkpoint.
+        std::size_t wal_pages;
+        mode checkpoint_mode;
+        // WAL size in pages triggering checkpoint of large_wal_mode,
+        // which resets the WAL so it stops growing.
+        std::size_t large_wal_pages;
+        mode large_wal_mode;
+        // Checkpoint non-empty WAL at least that often, zero disables.
+        std::chrono::milliseconds interval;
+        // Wait of restart and truncate checkpoints for readers and writer.
+        std::chrono::milliseconds busy_timeout;
+    };
+
+    // Checkpoint statistics.
+    struct stats
+    {
+        // WAL size in pages after the last commit, and maximal size.
+        std::size_t wal_pages;
+        std::size_t max_wal_pages;
+        // Number of checkpoints, and of those not completed or failed.
+        unsigned long long checkpoints;
+        unsigned long long incomplete;
+        // WAL frames and checkpointed frames of the last checkpoint.
+        int last_log_frames;
+        int last_checkpointed_frames;
+        // Error code of the last checkpoint.
+        int last_error;
+        // Last, total and maximal checkpoint duration.
+        std::chrono::nanoseconds last_duration;
+        std::chrono::nanoseconds total_duration;
+        std::chrono::nanoseconds max_duration;
+    };
+
+    // Watch WAL of writer session, checkpoint filename on own connection.
+    // Writer session must be open until the scheduler is destroyed.
+    checkpoint_scheduler(session& writer, text const& filename, options const& opts = options());
+
+    checkpoint_scheduler(checkpoint_scheduler const&) = delete;
+    checkpoint_scheduler& operator=(checkpoint_scheduler const&) = delete;
+
+    // Stop worker thread, restore automatic checkpoints of writer session
+    // with the interval it had before. Other WAL hooks are not restored.
+    ~checkpoint_scheduler();
+
+    // Request checkpoint of mode now, it runs asynchronously.
+    void request(mode m);
+
+    // Checkpoint statistics.
+    stats statistics() const;
+
+private:
+    // sqlite3_wal_hook callback.
+    static int on_commit(void* self, sqlite3* db, char const* name, int pages);
+
+    // Worker thread.
+    void run();
+
+    session& writer_;
+    session conn_;
+    options const opts_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wakeup_;
+    bool stop_;
+    // Requested checkpoint mode, or -1.
+    int requested_;
+    // WAL frames checkpointed already, and pages written since.
+    std::size_t backfilled_;
+    std::size_t pending_;
+    // Pending pages reached wal_pages.
+    bool due_;
+    // Automatic checkpoint interval of writer session, to restore.
+    int autocheckpoint_;
+    stats stats_;
+    std::thread worker_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_CHECKPOINT_SCHEDULER_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,147 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_COLUMNS_HPP_INCLUDED
+#define SQLITEPP_COLUMNS_HPP_INCLUDED
+
+#include <cstring>
+#include <vector>
+
+#include "string.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Variable size values stored back to back in one buffer.
+class byte_column
+{
+public:
+    // Number of values.
+    std::size_t size() const noexcept { return ends_.size(); }
+
+    // Are there no values?
+    bool empty() const noexcept { return ends_.empty(); }
+
+    // Is value i NULL?
+    bool is_null(std::size_t i) const noexcept { return nulls_[i]; }
+
+    // Total size of values in bytes.
+    std::size_t bytes() const noexcept { return bytes_.size(); }
+
+    // Remove all values, keep allocated storage.
+    void clear() noexcept
+    {
+        bytes_.clear();
+        ends_.clear();
+        nulls_.clear();
+    }
+
+    // Append NULL value.
+    void push_null()
+    {
+        append(nullptr, 0, false, true);
+    }
+
+    // Reserve storage for rows more values, of average size seen so far.
+    void reserve(std::size_t rows)
+    {
+        grow(ends_, ends_.size() + rows);
+        grow(nulls_, nulls_.size() + rows);
+        if ( !ends_.empty() )
+        {
+            grow(bytes_, bytes_.size() + bytes_.size() / ends_.size() * rows);
+        }
+    }
+
+protected:
+    void append(void const* data, std::size_t size, bool terminate, bool null)
+    {
+        char const* const p = static_cast<char const*>(data);
+        bytes_.insert(bytes_.end(), p, p + size);
+        if ( terminate ) bytes_.push_back('\0');
+        ends_.push_back(bytes_.size());
+        nulls_.push_back(null);
+    }
+
+    char const* data(std::size_t i) const noexcept
+    {
+        return bytes_.data() + (i ? ends_[i - 1] : 0);
+    }
+
+    std::size_t length(std::size_t i) const noexcept
+    {
+        return ends_[i] - (i ? ends_[i - 1] : 0);
+    }
+
+private:
+    // Grow capacity geometrically, repeated reserves stay amortized.
+    template<typename V>
+    static void grow(V& v, std::size_t n)
+    {
+        if ( n > v.capacity() ) v.reserve(n < 2 * v.capacity() ? 2 * v.capacity() : n);
+    }
+
+    std::vector<char> bytes_;
+    std::vector<std::size_t> ends_;
+    std::vector<bool> nulls_;
+};
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Column of UTF-8 texts in one buffer, filled by into_rows().
+class text_column : public detail::byte_column
+{
+public:
+    // Append value, NULL for null data.
+    void push_back(text const& t)
+    {
+        if ( t.data ) append(t.data, t.size != std::size_t(-1) ? t.size : std::strlen(t.data), true, false);
+        else push_null();
+    }
+
+    // Value i, nul-terminated, with null data for NULL.
+    // Valid until the column is changed.
+    text operator[](std::size_t i) const noexcept
+    {
+        return is_null(i) ? text() : text(data(i), length(i) - 1);
+    }
+};
+
+// Column of BLOBs in one buffer, filled by into_rows().
+class blob_column : public detail::byte_column
+{
+public:
+    // Append value, SQLite returns null data for empty BLOBs too.
+    void push_back(blob const& b)
+    {
+        append(b.data, b.size, false, false);
+    }
+
+    // Value i, with null data for NULL. Valid until the column is changed.
+    blob operator[](std::size_t i) const noexcept
+    {
+        blob const b = { is_null(i) ? nullptr : data(i), length(i) };
+        return b;
+    }
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_COLUMNS_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
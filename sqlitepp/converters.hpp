@@ -9,8 +9,18 @@
 #define SQLITEPP_CONVERTERS_HPP_INCLUDED
 
 #include "string.hpp"
+#include <cstddef>
 #include <type_traits>
 
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
+
+#if __cplusplus >= 202002L && __has_include(<span>)
+#include <span>
+#define SQLITEPP_HAS_SPAN 1
+#endif
+
 //////////////////////////////////////////////////////////////////////////////
 
 namespace sqlitepp {
@@ -56,6 +66,17 @@ template<> struct converter<text16> : converter_base<text16, text16> {};
 template<typename T>
 struct converter<T, typename std::enable_if<std::is_enum<T>::value>::type> : converter_base<T, int> {};
 
+// Use only, binds NULL.
+template<>
+struct converter<std::nullptr_t>
+{
+    typedef std::nullptr_t base_type;
+    static std::nullptr_t from(std::nullptr_t)
+    {
+        return nullptr;
+    }
+};
+
 template<>
 struct converter<char const*>
 {
@@ -112,6 +133,81 @@ struct converter<u16string>
     }
 };
 
+#if __cplusplus >= 201703L
+
+// View of column text, without copy. NULL is an empty view with null data.
+template<>
+struct converter<std::string_view>
+{
+    typedef text base_type;
+    static std::string_view to(text const& b)
+    {
+        return b.data ? std::string_view(b.data, b.size) : std::string_view();
+    }
+    static text from(std::string_view t)
+    {
+        // view is not nul-terminated
+        text b;
+        b.data = t.data();
+        b.size = t.size();
+        return b;
+    }
+};
+
+template<>
+struct converter<std::u16string_view>
+{
+    typedef text16 base_type;
+    static std::u16string_view to(text16 const& b)
+    {
+        return b.data ? std::u16string_view(b.data, b.size) : std::u16string_view();
+    }
+    static text16 from(std::u16string_view t)
+    {
+        text16 b;
+        b.data = t.data();
+        b.size = t.size();
+        return b;
+    }
+};
+
+#endif
+
+#ifdef SQLITEPP_HAS_SPAN
+
+// View of column BLOB, without copy.
+template<>
+struct converter<std::span<std::byte const>>
+{
+    typedef blob base_type;
+    static std::span<std::byte const> to(blob const& b)
+    {
+        return std::span<std::byte const>(static_cast<std::byte const*>(b.data), b.size);
+    }
+    static blob from(std::span<std::byte const> t)
+    {
+        blob const b = { t.data(), t.size() };
+        return b;
+    }
+};
+
+#endif
+
+// Does T point into a column value, valid until the statement steps or resets?
+template<typename T> struct is_column_view : std::false_type {};
+template<> struct is_column_view<blob> : std::true_type {};
+template<> struct is_column_view<text> : std::true_type {};
+template<> struct is_column_view<text16> : std::true_type {};
+template<> struct is_column_view<char const*> : std::true_type {};
+template<> struct is_column_view<char16_t const*> : std::true_type {};
+#if __cplusplus >= 201703L
+template<> struct is_column_view<std::string_view> : std::true_type {};
+template<> struct is_column_view<std::u16string_view> : std::true_type {};
+#endif
+#ifdef SQLITEPP_HAS_SPAN
+template<> struct is_column_view<std::span<std::byte const>> : std::true_type {};
+#endif
+
 //////////////////////////////////////////////////////////////////////////////
 
 } //namespace sqlitepp
@@ -5,6 +5,8 @@
 // Boost Software License, Version 1.0. (See accompanying file
 // LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
+#include <sqlite3.h>
+
 #include "exception.hpp"
 #include "string.hpp"
 
@@ -45,6 +47,21 @@ multi_stmt_not_supported::multi_stmt_not_supported() noexcept
 {
 }
 
+interrupted::interrupted() noexcept
+    : exception(SQLITE_INTERRUPT, "interrupted")
+{
+}
+
+interrupted::interrupted(text const& msg) noexcept
+    : exception(SQLITE_INTERRUPT, msg)
+{
+}
+
+deadline_exceeded::deadline_exceeded() noexcept
+    : interrupted("deadline exceeded")
+{
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 } // namespace sqlitepp
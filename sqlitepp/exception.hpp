@@ -32,6 +32,7 @@ private:
     int code_;
 };
 
+// Not thrown since transactions nest with savepoints, kept for compatibility.
 struct SQLITEPP_API nested_txn_not_supported : exception
 {
     nested_txn_not_supported() noexcept;
@@ -52,6 +53,20 @@ struct SQLITEPP_API multi_stmt_not_supported : exception
     multi_stmt_not_supported() noexcept;
 };
 
+// Statement interrupted by session::interrupt() or cancellation.
+struct SQLITEPP_API interrupted : exception
+{
+    interrupted() noexcept;
+protected:
+    explicit interrupted(text const& msg) noexcept;
+};
+
+// Statement interrupted by session or statement deadline.
+struct SQLITEPP_API deadline_exceeded : interrupted
+{
+    deadline_exceeded() noexcept;
+};
+
 //////////////////////////////////////////////////////////////////////////////
 
 } // namespace sqlitepp
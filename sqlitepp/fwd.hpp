@@ -31,15 +31,30 @@ namespace sqlitepp {
 //////////////////////////////////////////////////////////////////////////////
 
 class session;
+struct busy_policy;
+struct busy_stats;
+struct session_options;
+struct session_metrics;
+struct statement_metrics;
+struct scan_loop;
 class query;
 class prepare_query;
 class once_query;
 class statement;
+class statement_cache;
+class blob_stream;
+class bulk_insert;
+class checkpoint_scheduler;
+class slow_query_log;
+class async_session;
 class transaction;
+template<typename Signature> class typed_statement;
 class exception;
 struct blob;
 struct text;
 struct text16;
+class text_column;
+class blob_column;
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -8,7 +8,10 @@
 #ifndef SQLITEPP_INTO_HPP_INCLUDED
 #define SQLITEPP_INTO_HPP_INCLUDED
 
+#include <vector>
+
 #include "binders.hpp"
+#include "columns.hpp"
 #include "converters.hpp"
 #include "string.hpp"
 #include "statement.hpp"
@@ -30,9 +33,17 @@ public:
     {
     }
 
+    into_pos_binder(into_pos_binder&&) = default;
+
+    operator into_binder_ptr() &&
+    {
+        return into_binder_ptr(new into_pos_binder(std::move(*this)));
+    }
+
     int bind(statement&, int pos) override
     {
         if (this->pos_ < 0) this->pos_ = pos;
+        this->scalar(scalar_kind_of<T>::value, &this->value_, this->pos_);
         return this->pos_;
     }
 
@@ -57,13 +68,20 @@ public:
         : into_pos_binder<T>(value, -1)
         , name_(name.to_string()) {}
 
+    into_name_binder(into_name_binder&&) = default;
+
+    operator into_binder_ptr() &&
+    {
+        return into_binder_ptr(new into_name_binder(std::move(*this)));
+    }
+
     int bind(statement& st, int) override
     {
         if ( this->pos_ < 0 )
         {
             this->pos_ = st.column_index(this->name_);
         }
-        return this->pos_;
+        return into_pos_binder<T>::bind(st, this->pos_);
     }
 
 protected:
@@ -71,18 +89,142 @@ protected:
 };
 
 // Create position into binding for reference t.
+// Binder is stored in query without heap allocation,
+// it converts to into_binder_ptr if needed.
 template<typename T>
-inline into_binder_ptr into(T& t, int pos = -1)
+inline into_pos_binder<T> into(T& t, int pos = -1)
 {
-    return into_binder_ptr(new into_pos_binder<T>(t, pos));
+    return into_pos_binder<T>(t, pos);
 }
 //----------------------------------------------------------------------------
 
 // Create named into binding for reference t.
 template<typename T>
-inline into_binder_ptr into(T& t, text const& name)
+inline into_name_binder<T> into(T& t, text const& name)
+{
+    return into_name_binder<T>(t, name);
+}
+//----------------------------------------------------------------------------
+
+template<typename C> struct rows_kind_of : std::integral_constant<scalar_kind, scalar_kind::none> {};
+template<> struct rows_kind_of<std::vector<int>> : std::integral_constant<scalar_kind, scalar_kind::int32_rows> {};
+template<> struct rows_kind_of<std::vector<long long>> : std::integral_constant<scalar_kind, scalar_kind::int64_rows> {};
+template<> struct rows_kind_of<std::vector<double>> : std::integral_constant<scalar_kind, scalar_kind::real_rows> {};
+template<> struct rows_kind_of<text_column> : std::integral_constant<scalar_kind, scalar_kind::text_rows> {};
+template<> struct rows_kind_of<blob_column> : std::integral_constant<scalar_kind, scalar_kind::blob_rows> {};
+
+/// Into binder appending column value of each row to container C:
+/// std::vector<T>, text_column or blob_column.
+template<typename C>
+class into_rows_binder : public into_binder
+{
+public:
+    into_rows_binder(C& values, int pos)
+        : pos_(pos)
+        , values_(values)
+    {
+    }
+
+    into_rows_binder(C& values, text const& name)
+        : pos_(-1)
+        , values_(values)
+        , name_(name.to_string())
+    {
+    }
+
+    into_rows_binder(into_rows_binder&&) = default;
+
+    operator into_binder_ptr() &&
+    {
+        return into_binder_ptr(new into_rows_binder(std::move(*this)));
+    }
+
+    int bind(statement& st, int pos) override
+    {
+        if ( pos_ < 0 )
+        {
+            pos_ = name_.empty() ? pos : st.column_index(name_);
+        }
+        this->scalar(rows_kind_of<C>::value, &values_, pos_);
+        return pos_;
+    }
+
+    void update(statement& st) override
+    {
+        append(st, values_);
+    }
+
+    void reserve(std::size_t rows) override
+    {
+        reserve(values_, rows);
+    }
+
+private:
+    template<typename T>
+    void append(statement& st, std::vector<T>& values)
+    {
+        typename converter<T>::base_type t;
+        st.column_value(pos_, t);
+        values.push_back(converter<T>::to(t));
+    }
+
+    void append(statement& st, text_column& values)
+    {
+        text t;
+        st.column_value(pos_, t);
+        if ( t.data ) values.push_back(t);
+        else values.push_null();
+    }
+
+    void append(statement& st, blob_column& values)
+    {
+        if ( st.column_type(pos_) == statement::null )
+        {
+            values.push_null();
+        }
+        else
+        {
+            blob b;
+            st.column_value(pos_, b);
+            values.push_back(b);
+        }
+    }
+
+    template<typename T>
+    static void reserve(std::vector<T>& values, std::size_t rows)
+    {
+        std::size_t const n = values.size() + rows;
+        if ( n > values.capacity() )
+        {
+            // grow geometrically, repeated fetches stay amortized
+            values.reserve(n < 2 * values.capacity() ? 2 * values.capacity() : n);
+        }
+    }
+
+    static void reserve(detail::byte_column& values, std::size_t rows)
+    {
+        values.reserve(rows);
+    }
+
+    int pos_;
+    C& values_;
+    u8string name_;
+};
+
+// Create positional into binding appending column values of each row to v.
+// Container v is std::vector<T>, text_column or blob_column.
+template<typename C>
+inline into_rows_binder<C> into_rows(C& v, int pos = -1)
+{
+    return into_rows_binder<C>(v, pos);
+}
+//----------------------------------------------------------------------------
+
+// Create named into binding appending column values of each row to v.
+template<typename C>
+inline into_rows_binder<C> into_rows(C& v, text const& name)
 {
-    return into_binder_ptr(new into_name_binder<T>(t, name));
+    return into_rows_binder<C>(v, name);
 }
 //----------------------------------------------------------------------------
 
@@ -0,0 +1,134 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <iomanip>
+#include <ostream>
+
+#include "metrics.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+// Metric family header.
+void family(std::ostream& os, char const* name, char const* type, char const* help)
+{
+    os << "# HELP sqlitepp_" << name << ' ' << help << '\n'
+       << "# TYPE sqlitepp_" << name << ' ' << type << '\n';
+}
+//----------------------------------------------------------------------------
+
+void sample(std::ostream& os, char const* name, text const& labels, unsigned long long value)
+{
+    os << "sqlitepp_" << name;
+    if ( labels.data && *labels.data )
+    {
+        os << '{' << labels << '}';
+    }
+    os << ' ' << value << '\n';
+}
+//----------------------------------------------------------------------------
+
+void sample(std::ostream& os, char const* name, text const& labels, std::chrono::nanoseconds value)
+{
+    os << "sqlitepp_" << name;
+    if ( labels.data && *labels.data )
+    {
+        os << '{' << labels << '}';
+    }
+    // exact seconds from integer nanoseconds, double would round them
+    long long ns = value.count();
+    os << ' ';
+    if ( ns < 0 )
+    {
+        os << '-';
+        ns = -ns;
+    }
+    char const fill = os.fill('0');
+    os << ns / 1000000000 << '.' << std::setw(9) << ns % 1000000000 << '\n';
+    os.fill(fill);
+}
+//----------------------------------------------------------------------------
+
+template<typename T>
+void metric(std::ostream& os, char const* name, char const* type, char const* help,
+    text const& labels, T value)
+{
+    family(os, name, type, help);
+    sample(os, name, labels, value);
+}
+//----------------------------------------------------------------------------
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////////
+
+void write_prometheus(std::ostream& os, session_metrics const& m, text const& labels)
+{
+    metric(os, "cache_hits_total", "counter", "Page cache hits.", labels, m.cache_hits);
+    metric(os, "cache_misses_total", "counter", "Page cache misses.", labels, m.cache_misses);
+    metric(os, "cache_writes_total", "counter", "Pages written to disk.", labels, m.cache_writes);
+    metric(os, "cache_spills_total", "counter", "Pages spilled to disk mid-transaction.", labels, m.cache_spills);
+    metric(os, "cache_used_bytes", "gauge", "Heap used by page cache.", labels, m.cache_used);
+    metric(os, "schema_used_bytes", "gauge", "Heap used by schemas.", labels, m.schema_used);
+    metric(os, "statement_used_bytes", "gauge", "Heap used by prepared statements.", labels, m.statement_used);
+    metric(os, "lookaside_used", "gauge", "Lookaside memory slots in use.", labels, m.lookaside_used);
+    metric(os, "statement_cache_hits_total", "counter", "Prepared statement cache hits.", labels, m.statement_cache_hits);
+    metric(os, "statement_cache_misses_total", "counter", "Prepared statement cache misses.", labels, m.statement_cache_misses);
+    metric(os, "prepares_total", "counter", "Statement prepares.", labels, m.prepares);
+    metric(os, "prepare_seconds_total", "counter", "Time spent in prepares.", labels, m.prepare_time);
+    metric(os, "steps_total", "counter", "Statement steps.", labels, m.steps);
+    metric(os, "step_seconds_total", "counter", "Time spent in steps.", labels, m.step_time);
+    metric(os, "binds_total", "counter", "Use binder binds.", labels, m.binds);
+    metric(os, "bind_seconds_total", "counter", "Time spent in binds.", labels, m.bind_time);
+}
+//----------------------------------------------------------------------------
+
+void write_prometheus(std::ostream& os,
+    std::vector<std::pair<u8string, statement_metrics>> const& statements)
+{
+    struct counter
+    {
+        char const* name;
+        char const* type;
+        char const* help;
+        unsigned long long statement_metrics::* value;
+    };
+    static counter const counters[] =
+    {
+        { "statement_fullscan_steps_total", "counter", "Full table scan steps.", &statement_metrics::fullscan_steps },
+        { "statement_sorts_total", "counter", "Sort operations.", &statement_metrics::sorts },
+        { "statement_autoindex_rows_total", "counter", "Rows inserted into automatic indexes.", &statement_metrics::autoindex_rows },
+        { "statement_vm_steps_total", "counter", "Virtual machine operations.", &statement_metrics::vm_steps },
+        { "statement_reprepares_total", "counter", "Re-prepares after schema changes.", &statement_metrics::reprepares },
+        { "statement_runs_total", "counter", "Completed runs.", &statement_metrics::runs },
+        { "statement_filter_misses_total", "counter", "Bloom filter misses.", &statement_metrics::filter_misses },
+        { "statement_filter_hits_total", "counter", "Bloom filter hits.", &statement_metrics::filter_hits },
+        { "statement_memory_used_bytes", "gauge", "Heap used by statement.", &statement_metrics::memory_used },
+    };
+
+    // each family once, with samples of all statements
+    for (counter const& c : counters)
+    {
+        family(os, c.name, c.type, c.help);
+        for (auto const& st : statements)
+        {
+            sample(os, c.name, st.first, st.second.*c.value);
+        }
+    }
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
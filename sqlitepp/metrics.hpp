@@ -0,0 +1,114 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_METRICS_HPP_INCLUDED
+#define SQLITEPP_METRICS_HPP_INCLUDED
+
+#include <chrono>
+#include <iosfwd>
+#include <utility>
+#include <vector>
+
+#include "string.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Counters of a prepared statement, see sqlite3_stmt_status.
+// Counters not supported by the SQLite version are zero.
+struct SQLITEPP_API statement_metrics
+{
+    // Forward steps of full table scans.
+    unsigned long long fullscan_steps;
+    // Sort operations.
+    unsigned long long sorts;
+    // Rows inserted into automatic indexes.
+    unsigned long long autoindex_rows;
+    // Virtual machine operations.
+    unsigned long long vm_steps;
+    // Automatic re-prepares after schema changes.
+    unsigned long long reprepares;
+    // Completed runs.
+    unsigned long long runs;
+    // Bloom filter checks of joins, missed and hit.
+    unsigned long long filter_misses;
+    unsigned long long filter_hits;
+    // Bytes of heap used by the statement.
+    unsigned long long memory_used;
+};
+
+// Loop of a statement plan, see sqlite3_stmt_scanstatus.
+struct SQLITEPP_API scan_loop
+{
+    // EXPLAIN QUERY PLAN element of the loop and its parent,
+    // parent is -1 before SQLite 3.42.
+    int select_id;
+    int parent_id;
+    // Loop runs, and rows visited by all runs.
+    unsigned long long loops;
+    unsigned long long rows_visited;
+    // Rows per run estimated by the query planner.
+    double estimated_rows;
+    // Table or index the loop reads, and EXPLAIN QUERY PLAN text,
+    // e.g. "SEARCH t USING INDEX t_name (name=?)".
+    u8string name;
+    u8string explain;
+
+    // Actual rows per run.
+    double actual_rows() const noexcept
+    {
+        return loops ? static_cast<double>(rows_visited) / loops : 0.0;
+    }
+};
+
+// Connection counters, see sqlite3_db_status, with timings of
+// sqlitepp wrapper calls when enabled by session::enable_timings.
+struct SQLITEPP_API session_metrics
+{
+    // Page cache hits, misses, pages written and spilled mid-transaction.
+    unsigned long long cache_hits;
+    unsigned long long cache_misses;
+    unsigned long long cache_writes;
+    unsigned long long cache_spills;
+    // Bytes of heap used by page cache, schemas, prepared statements and lookaside.
+    unsigned long long cache_used;
+    unsigned long long schema_used;
+    unsigned long long statement_used;
+    unsigned long long lookaside_used;
+    // Prepared statement cache hits and misses.
+    unsigned long long statement_cache_hits;
+    unsigned long long statement_cache_misses;
+    // Number and total time of prepares, steps and use binder binds.
+    unsigned long long prepares;
+    std::chrono::nanoseconds prepare_time;
+    unsigned long long steps;
+    std::chrono::nanoseconds step_time;
+    unsigned long long binds;
+    std::chrono::nanoseconds bind_time;
+};
+
+// Write metrics in Prometheus text exposition format, with labels like
+// `db="main"` added to each sample.
+SQLITEPP_API void write_prometheus(std::ostream& os, session_metrics const& m, text const& labels = "");
+
+// Write metrics of statements in Prometheus text exposition format,
+// each with its labels, e.g. `query="users_by_id"`.
+SQLITEPP_API void write_prometheus(std::ostream& os,
+    std::vector<std::pair<u8string, statement_metrics>> const& statements);
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_METRICS_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
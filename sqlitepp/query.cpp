@@ -5,6 +5,8 @@
 // Boost Software License, Version 1.0. (See accompanying file
 // LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
+#include <cstdlib>
+
 #include "query.hpp"
 #include "exception.hpp"
 #include "statement.hpp"
@@ -37,16 +39,25 @@ query& query::operator=(query&& src) noexcept
     return *this;
 }
 
-query::~query() = default;
+query::~query()
+{
+    clear();
+}
 
 void query::swap(query& other) noexcept
 {
+    arena_.swap(other.arena_);
     intos_.swap(other.intos_);
     uses_.swap(other.uses_);
     sql_.swap(other.sql_);
 }
 
 std::string query::sql() const
+{
+    return std::string(sql_.str().data, sql_.size());
+}
+
+text query::sql_text() const noexcept
 {
     return sql_.str();
 }
@@ -54,9 +65,9 @@ std::string query::sql() const
 
 void query::clear() noexcept
 {
-    intos_.clear();
-    uses_.clear();
-    sql_.str(std::string());
+    intos_.destroy();
+    uses_.destroy();
+    arena_.release();
     sql_.clear();
 }
 //----------------------------------------------------------------------------
@@ -67,7 +78,9 @@ query& query::put(into_binder_ptr i)
     {
         throw std::invalid_argument("null into binder");
     }
-    intos_.emplace_back(std::move(i));
+    typedef binder_list<into_binder>::node node;
+    void* const n = arena_.allocate(sizeof(node), alignof(node));
+    intos_.link(static_cast<node*>(n), i.release(), true);
     return *this;
 }
 //----------------------------------------------------------------------------
@@ -84,7 +97,9 @@ query& query::put(use_binder_ptr u)
     {
         throw std::invalid_argument("null use binder");
     }
-    uses_.emplace_back(std::move(u));
+    typedef binder_list<use_binder>::node node;
+    void* const n = arena_.allocate(sizeof(node), alignof(node));
+    uses_.link(static_cast<node*>(n), u.release(), true);
     return *this;
 }
 //----------------------------------------------------------------------------
@@ -95,6 +110,57 @@ query& query::operator,(use_binder_ptr u)
 }
 //----------------------------------------------------------------------------
 
+// aligned so that data() is suitable for any binder
+struct alignas(std::max_align_t) query::arena::block
+{
+    block* next;
+    std::size_t size;
+    std::size_t used;
+
+    char* data() noexcept { return reinterpret_cast<char*>(this + 1); }
+};
+//----------------------------------------------------------------------------
+
+void* query::arena::allocate(std::size_t size, std::size_t align)
+{
+    // enough for a dozen of binders with their list nodes
+    std::size_t const block_size = 1024;
+
+    if ( block* b = blocks_ )
+    {
+        std::size_t const offset = (b->used + align - 1) & ~(align - 1);
+        if ( offset + size <= b->size )
+        {
+            b->used = offset + size;
+            return b->data() + offset;
+        }
+    }
+
+    std::size_t const capacity = size > block_size ? size : block_size;
+    void* const mem = std::malloc(sizeof(block) + capacity);
+    if ( !mem )
+    {
+        throw std::bad_alloc();
+    }
+    block* const b = static_cast<block*>(mem);
+    b->next = blocks_;
+    b->size = capacity;
+    b->used = size;
+    blocks_ = b;
+    return b->data();
+}
+//----------------------------------------------------------------------------
+
+void query::arena::release() noexcept
+{
+    while ( block* b = blocks_ )
+    {
+        blocks_ = b->next;
+        std::free(b);
+    }
+}
+//----------------------------------------------------------------------------
+
 
 //////////////////////////////////////////////////////////////////////////////
 //
@@ -8,10 +8,13 @@
 #ifndef SQLITEPP_PROXIES_HPP_INCLUDED
 #define SQLITEPP_PROXIES_HPP_INCLUDED
 
-#include <vector>
-#include <sstream>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
 
 #include "binders.hpp"
+#include "sql_builder.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -41,6 +44,9 @@ public:
     // Current SQL statement.
     std::string sql() const;
 
+    // Current SQL statement without copy, valid until the query is changed.
+    text sql_text() const noexcept;
+
     // Clear sql text, into and use bindings.
     void clear() noexcept;
 
@@ -60,11 +66,126 @@ public:
     query& put(use_binder_ptr i);
     query& operator,(use_binder_ptr u);
 
+    // Add into binder, stored in the query without heap allocation.
+    template<typename B>
+    typename std::enable_if<std::is_base_of<into_binder, B>::value, query&>::type
+    put(B&& i)
+    {
+        emplace(intos_, std::move(i));
+        return *this;
+    }
+
+    template<typename B>
+    typename std::enable_if<std::is_base_of<into_binder, B>::value, query&>::type
+    operator,(B&& i)
+    {
+        return put(std::move(i));
+    }
+
+    // Add use binder, stored in the query without heap allocation.
+    template<typename B>
+    typename std::enable_if<std::is_base_of<use_binder, B>::value, query&>::type
+    put(B&& u)
+    {
+        emplace(uses_, std::move(u));
+        return *this;
+    }
+
+    template<typename B>
+    typename std::enable_if<std::is_base_of<use_binder, B>::value, query&>::type
+    operator,(B&& u)
+    {
+        return put(std::move(u));
+    }
+
 private:
-    std::vector<into_binder_ptr> intos_;
-    std::vector<use_binder_ptr> uses_;
+    // Memory for binders, one block serves many of them.
+    // Blocks are freed all at once on clear.
+    class arena
+    {
+    public:
+        arena() noexcept : blocks_(nullptr) {}
+        ~arena() { release(); }
+
+        void* allocate(std::size_t size, std::size_t align);
+        void release() noexcept;
+        void swap(arena& other) noexcept { std::swap(blocks_, other.blocks_); }
+
+    private:
+        struct block;
+        block* blocks_;
+    };
+
+    // Singly linked list of binders in order of addition.
+    template<typename B>
+    struct binder_list
+    {
+        struct node
+        {
+            node* next;
+            B* binder;
+            bool owned; // allocated by new, not in arena
+        };
+
+        class iterator
+        {
+        public:
+            explicit iterator(node* n) noexcept : n_(n) {}
+            B& operator*() const noexcept { return *n_->binder; }
+            iterator& operator++() noexcept { n_ = n_->next; return *this; }
+            bool operator!=(iterator const& other) const noexcept { return n_ != other.n_; }
+        private:
+            node* n_;
+        };
+
+        binder_list() noexcept : first(nullptr), last(nullptr) {}
+
+        iterator begin() const noexcept { return iterator(first); }
+        iterator end() const noexcept { return iterator(nullptr); }
+
+        void link(node* n, B* binder, bool owned) noexcept
+        {
+            n->next = nullptr;
+            n->binder = binder;
+            n->owned = owned;
+            (last ? last->next : first) = n;
+            last = n;
+        }
+
+        void destroy() noexcept
+        {
+            for (node* n = first; n; n = n->next)
+            {
+                if ( n->owned ) delete n->binder;
+                else n->binder->~B();
+            }
+            first = last = nullptr;
+        }
+
+        void swap(binder_list& other) noexcept
+        {
+            std::swap(first, other.first);
+            std::swap(last, other.last);
+        }
+
+        node* first;
+        node* last;
+    };
+
+    template<typename List, typename B>
+    void emplace(List& list, B&& binder)
+    {
+        typedef typename List::node node;
+        void* const n = arena_.allocate(sizeof(node), alignof(node));
+        void* const p = arena_.allocate(sizeof(B), alignof(B));
+        list.link(static_cast<node*>(n), new (p) B(std::move(binder)), false);
+    }
+
+    arena arena_;
+    binder_list<into_binder> intos_;
+    binder_list<use_binder> uses_;
 
-    std::ostringstream sql_;
+    sql_builder sql_;
 };
 
 // Statement preparing proxy.
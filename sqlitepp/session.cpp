@@ -8,6 +8,9 @@
 #include <sqlite3.h>
 
 #include <cassert>
+#include <random>
+#include <string>
+#include <thread>
 
 #include "session.hpp"
 #include "exception.hpp"
@@ -26,11 +29,75 @@ namespace sqlitepp {
 
 //////////////////////////////////////////////////////////////////////////////
 
+struct session::busy_state
+{
+    typedef std::chrono::steady_clock clock;
+
+    explicit busy_state(busy_policy const& p)
+        : policy(p)
+        , stats()
+        , random(static_cast<std::minstd_rand::result_type>(clock::now().time_since_epoch().count()))
+        , waiting(false)
+    {
+    }
+
+    // Delay before attempt count + 1.
+    clock::duration delay(int count)
+    {
+        double d = static_cast<double>(policy.initial_delay.count());
+        for (int i = 0; i < count && d < policy.max_delay.count(); ++i) d *= policy.multiplier;
+        if ( d > policy.max_delay.count() ) d = static_cast<double>(policy.max_delay.count());
+        if ( policy.jitter > 0 )
+        {
+            d *= 1.0 - policy.jitter * std::uniform_real_distribution<double>(0.0, 1.0)(random);
+        }
+        return std::chrono::microseconds(static_cast<long long>(d));
+    }
+
+    // Account current event, it ended after the last wait.
+    void end_event()
+    {
+        if ( !waiting )
+        {
+            return;
+        }
+        waiting = false;
+
+        std::chrono::nanoseconds const wait = last - start;
+        stats.total_wait += wait;
+        if ( wait > stats.max_wait ) stats.max_wait = wait;
+
+        long long const ms = std::chrono::duration_cast<std::chrono::milliseconds>(wait).count();
+        std::size_t bucket = 0;
+        while ( bucket + 1 < busy_stats::buckets && (1ll << bucket) <= ms ) ++bucket;
+        ++stats.histogram[bucket];
+    }
+
+    busy_policy policy;
+    busy_stats stats;
+    std::minstd_rand random;
+    // Is there a busy event being waited?
+    bool waiting;
+    clock::time_point start;
+    clock::time_point last;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
 // Create an empty session.
 session::session() noexcept
     : impl_(nullptr)
     , active_txn_(nullptr)
     , last_exec_(false)
+    , controls_()
+    , timed_(false)
+    , timings_()
+    , fullscan_steps_(0)
+    , deadline_(std::chrono::steady_clock::time_point::max())
+    , step_deadline_(std::chrono::steady_clock::time_point::max())
+    , deadline_steps_(1000)
+    , deadline_hit_(false)
+    , cancel_(nullptr)
 {
 }
 //----------------------------------------------------------------------------
@@ -49,6 +116,13 @@ session::session(text const& filename, enum encoding encoding, unsigned flags)
 }
 //----------------------------------------------------------------------------
 
+session::session(text const& filename, session_options const& opts, unsigned flags)
+      : session()
+{
+    open(filename, opts, flags);
+}
+//----------------------------------------------------------------------------
+
 session::~session()
 {
     close(true);
@@ -85,6 +159,11 @@ void session::open(text const& filename, unsigned flags)
         // @see sqlite3_errcode()
         throw exception(sqlite3_extended_errcode(impl_), sqlite3_errmsg(impl_));
     }
+    if ( busy_ )
+    {
+        sqlite3_busy_handler(impl_, on_busy, busy_.get());
+    }
+    watch_deadline();
 }
 //----------------------------------------------------------------------------
 
@@ -102,6 +181,330 @@ void session::open(text const& filename, enum encoding encoding, unsigned flags)
 }
 //----------------------------------------------------------------------------
 
+void session::open(text const& filename, session_options const& opts, unsigned flags)
+{
+    open(filename, flags);
+    apply(opts);
+}
+//----------------------------------------------------------------------------
+
+namespace {
+
+char const* const journal_modes[] = { "", "delete", "truncate", "persist", "memory", "wal", "off" };
+
+// Integer result of pragma query, 0 without result.
+long long pragma_value(sqlite3* db, char const* sql)
+{
+    long long value = 0;
+    sqlite3_stmt* st = nullptr;
+    if ( sqlite3_prepare_v2(db, sql, -1, &st, nullptr) == SQLITE_OK && sqlite3_step(st) == SQLITE_ROW )
+    {
+        value = sqlite3_column_int64(st, 0);
+    }
+    sqlite3_finalize(st);
+    return value;
+}
+
+} // namespace
+
+void session::apply(session_options const& opts)
+{
+    typedef session_options so;
+
+    // page size first, it can't change after switching to WAL
+    std::string sql;
+    if ( opts.page_size )
+    {
+        sql += "pragma page_size = " + std::to_string(opts.page_size) + ";";
+    }
+    if ( opts.journal != so::journal_mode::keep )
+    {
+        sql += std::string("pragma journal_mode = ") + journal_modes[static_cast<int>(opts.journal)] + ";";
+    }
+    if ( opts.sync != so::synchronous::keep )
+    {
+        sql += "pragma synchronous = " + std::to_string(static_cast<int>(opts.sync) - 1) + ";";
+    }
+    if ( opts.temp != so::temp_store::keep )
+    {
+        sql += "pragma temp_store = " + std::to_string(static_cast<int>(opts.temp)) + ";";
+    }
+    if ( opts.cache_size )
+    {
+        sql += "pragma cache_size = " + std::to_string(opts.cache_size) + ";";
+    }
+    if ( opts.mmap_size >= 0 )
+    {
+        sql += "pragma mmap_size = " + std::to_string(opts.mmap_size) + ";";
+    }
+    if ( opts.query_only != so::query_only_mode::keep )
+    {
+        sql += "pragma query_only = " + std::to_string(static_cast<int>(opts.query_only) - 1) + ";";
+    }
+    if ( !sql.empty() )
+    {
+        check_error( sqlite3_exec(impl_, sql.c_str(), nullptr, nullptr, nullptr) );
+    }
+}
+//----------------------------------------------------------------------------
+
+session_options session::options() const
+{
+    if ( !is_open() )
+    {
+        throw session_not_open();
+    }
+    typedef session_options so;
+
+    so opts;
+    opts.journal = so::journal_mode::keep;
+    sqlite3_stmt* st = nullptr;
+    if ( sqlite3_prepare_v2(impl_, "pragma journal_mode", -1, &st, nullptr) == SQLITE_OK
+        && sqlite3_step(st) == SQLITE_ROW )
+    {
+        char const* const mode = reinterpret_cast<char const*>(sqlite3_column_text(st, 0));
+        for (int i = 1; mode && i < static_cast<int>(sizeof(journal_modes) / sizeof(*journal_modes)); ++i)
+        {
+            if ( sqlite3_stricmp(mode, journal_modes[i]) == 0 ) opts.journal = static_cast<so::journal_mode>(i);
+        }
+    }
+    sqlite3_finalize(st);
+
+    opts.sync = static_cast<so::synchronous>(pragma_value(impl_, "pragma synchronous") + 1);
+    // 0 is the compile time default
+    opts.temp = static_cast<so::temp_store>(pragma_value(impl_, "pragma temp_store"));
+    opts.page_size = static_cast<int>(pragma_value(impl_, "pragma page_size"));
+    opts.cache_size = pragma_value(impl_, "pragma cache_size");
+    opts.mmap_size = pragma_value(impl_, "pragma mmap_size");
+    opts.query_only = pragma_value(impl_, "pragma query_only") != 0
+        ? so::query_only_mode::on : so::query_only_mode::off;
+    return opts;
+}
+//----------------------------------------------------------------------------
+
+void session::set_busy_policy(busy_policy const& policy)
+{
+    if ( !is_open() )
+    {
+        throw session_not_open();
+    }
+    std::unique_ptr<busy_state> state(new busy_state(policy));
+    check_error( sqlite3_busy_handler(impl_, on_busy, state.get()) );
+    busy_ = std::move(state);
+}
+//----------------------------------------------------------------------------
+
+void session::clear_busy_policy()
+{
+    if ( is_open() )
+    {
+        sqlite3_busy_handler(impl_, nullptr, nullptr);
+    }
+    busy_.reset();
+}
+//----------------------------------------------------------------------------
+
+busy_stats session::busy_statistics() const
+{
+    if ( !busy_ )
+    {
+        return busy_stats();
+    }
+    // the handler is not called anymore once the lock is acquired
+    busy_->end_event();
+    return busy_->stats;
+}
+//----------------------------------------------------------------------------
+
+void session::enable_timings(bool enable) noexcept
+{
+    timed_.store(enable, std::memory_order_relaxed);
+}
+//----------------------------------------------------------------------------
+
+session_metrics session::metrics() const
+{
+    session_metrics m = session_metrics();
+    if ( is_open() )
+    {
+        struct status { int op; unsigned long long session_metrics::* value; };
+        static status const statuses[] =
+        {
+            { SQLITE_DBSTATUS_CACHE_HIT, &session_metrics::cache_hits },
+            { SQLITE_DBSTATUS_CACHE_MISS, &session_metrics::cache_misses },
+            { SQLITE_DBSTATUS_CACHE_WRITE, &session_metrics::cache_writes },
+#ifdef SQLITE_DBSTATUS_CACHE_SPILL
+            { SQLITE_DBSTATUS_CACHE_SPILL, &session_metrics::cache_spills },
+#endif
+            { SQLITE_DBSTATUS_CACHE_USED, &session_metrics::cache_used },
+            { SQLITE_DBSTATUS_SCHEMA_USED, &session_metrics::schema_used },
+            { SQLITE_DBSTATUS_STMT_USED, &session_metrics::statement_used },
+            { SQLITE_DBSTATUS_LOOKASIDE_USED, &session_metrics::lookaside_used },
+        };
+        for (status const& s : statuses)
+        {
+            int current = 0, highwater = 0;
+            if ( sqlite3_db_status(impl_, s.op, &current, &highwater, 0) == SQLITE_OK )
+            {
+                m.*s.value = static_cast<unsigned long long>(current);
+            }
+        }
+    }
+    m.statement_cache_hits = cache_.hits();
+    m.statement_cache_misses = cache_.misses();
+
+    std::memory_order const relaxed = std::memory_order_relaxed;
+    m.prepares = timings_.prepares.load(relaxed);
+    m.prepare_time = std::chrono::nanoseconds(timings_.prepare_ns.load(relaxed));
+    m.steps = timings_.steps.load(relaxed);
+    m.step_time = std::chrono::nanoseconds(timings_.step_ns.load(relaxed));
+    m.binds = timings_.binds.load(relaxed);
+    m.bind_time = std::chrono::nanoseconds(timings_.bind_ns.load(relaxed));
+    return m;
+}
+//----------------------------------------------------------------------------
+
+void session::set_fullscan_guard(unsigned long long steps, fullscan_handler handler)
+{
+    fullscan_steps_ = steps;
+    fullscan_handler_ = std::move(handler);
+}
+//----------------------------------------------------------------------------
+
+void session::clear_fullscan_guard() noexcept
+{
+    fullscan_handler_ = nullptr;
+}
+//----------------------------------------------------------------------------
+
+void session::interrupt() noexcept
+{
+    if ( sqlite3* const db = impl_ )
+    {
+        sqlite3_interrupt(db);
+    }
+}
+//----------------------------------------------------------------------------
+
+void session::set_deadline(std::chrono::steady_clock::time_point deadline)
+{
+#ifdef SQLITE_OMIT_PROGRESS_CALLBACK
+    (void)deadline;
+    throw exception(SQLITE_MISUSE, "deadlines need SQLite built without SQLITE_OMIT_PROGRESS_CALLBACK");
+#else
+    deadline_ = step_deadline_ = deadline;
+    watch_deadline();
+#endif
+}
+//----------------------------------------------------------------------------
+
+void session::clear_deadline() noexcept
+{
+    deadline_ = step_deadline_ = std::chrono::steady_clock::time_point::max();
+    watch_deadline();
+}
+//----------------------------------------------------------------------------
+
+void session::set_deadline_granularity(int vm_steps)
+{
+    if ( vm_steps < 1 )
+    {
+        throw exception(SQLITE_RANGE, sqlite3_errstr(SQLITE_RANGE));
+    }
+    deadline_steps_ = vm_steps;
+    watch_deadline();
+}
+//----------------------------------------------------------------------------
+
+void session::watch_deadline() noexcept
+{
+#ifndef SQLITE_OMIT_PROGRESS_CALLBACK
+    if ( impl_ )
+    {
+        if ( step_deadline_ != std::chrono::steady_clock::time_point::max() || cancel_ )
+        {
+            sqlite3_progress_handler(impl_, deadline_steps_, on_progress, this);
+        }
+        else
+        {
+            sqlite3_progress_handler(impl_, 0, nullptr, nullptr);
+        }
+    }
+#endif
+}
+//----------------------------------------------------------------------------
+
+int session::on_progress(void* self)
+{
+    session& s = *static_cast<session*>(self);
+    if ( s.cancel_ && *s.cancel_ )
+    {
+        return 1;
+    }
+    if ( s.step_deadline_ != std::chrono::steady_clock::time_point::max()
+        && std::chrono::steady_clock::now() >= s.step_deadline_ )
+    {
+        s.deadline_hit_ = true;
+        return 1;
+    }
+    return 0;
+}
+//----------------------------------------------------------------------------
+
+session::deadline_scope::deadline_scope(session& s, std::chrono::steady_clock::time_point deadline) noexcept
+    : s_(s)
+    , saved_(s.step_deadline_)
+{
+    if ( deadline < saved_ )
+    {
+        s_.step_deadline_ = deadline;
+        if ( saved_ == std::chrono::steady_clock::time_point::max() )
+        {
+            s_.watch_deadline();
+        }
+    }
+}
+//----------------------------------------------------------------------------
+
+session::deadline_scope::~deadline_scope()
+{
+    if ( s_.step_deadline_ != saved_ )
+    {
+        s_.step_deadline_ = saved_;
+        if ( saved_ == std::chrono::steady_clock::time_point::max() )
+        {
+            s_.watch_deadline();
+        }
+    }
+}
+//----------------------------------------------------------------------------
+
+int session::on_busy(void* state, int count)
+{
+    busy_state& b = *static_cast<busy_state*>(state);
+    busy_state::clock::time_point const now = busy_state::clock::now();
+    if ( count == 0 )
+    {
+        b.end_event();
+        b.waiting = true;
+        b.start = b.last = now;
+        ++b.stats.events;
+    }
+
+    busy_state::clock::duration const left = b.policy.max_wait - (now - b.start);
+    if ( left <= busy_state::clock::duration::zero() )
+    {
+        ++b.stats.timeouts;
+        b.last = now;
+        b.end_event();
+        return 0;
+    }
+    std::this_thread::sleep_for(std::min(b.delay(count), left));
+    b.last = busy_state::clock::now();
+    return 1;
+}
+//----------------------------------------------------------------------------
+
 enum encoding session::encoding() const noexcept
 {
     enum encoding e = encoding::unknown;
@@ -114,6 +517,10 @@ void session::close(bool force)
 {
     if (is_open())
     {
+        // cached statements would keep the connection busy
+        cache_.clear();
+        finalize_controls();
+
         // http://sqlite.org/c3ref/close.html
         // Call with a NULL pointer argument is a harmless no-op.
         int const r = (force ? sqlite3_close_v2 : sqlite3_close)(impl_);
@@ -143,6 +550,18 @@ bool session::last_exec() const noexcept
 }
 //----------------------------------------------------------------------------
 
+statement_cache& session::cache() noexcept
+{
+    return cache_;
+}
+//----------------------------------------------------------------------------
+
+statement_cache const& session::cache() const noexcept
+{
+    return cache_;
+}
+//----------------------------------------------------------------------------
+
 sqlite3* session::impl() const noexcept
 {
     return impl_;
@@ -194,6 +613,15 @@ void session::check_error(int code) const
     case SQLITE_MISUSE:
         throw exception(code, sqlite3_errstr(code));
 
+    case SQLITE_INTERRUPT:
+        if ( deadline_hit_ )
+        {
+            // a later interrupt of another call is not the deadline
+            deadline_hit_ = false;
+            throw deadline_exceeded();
+        }
+        throw interrupted();
+
     default:
         throw exception(code, sqlite3_errmsg(impl_));
     }
@@ -206,6 +634,60 @@ void session::check_last_error() const
 }
 //----------------------------------------------------------------------------
 
+void session::exec_control(control c)
+{
+    static char const* const sql[control_count] =
+    {
+        "begin deferred",
+        "begin immediate",
+        "begin exclusive",
+        "commit",
+        "rollback",
+        // SQLite releases or rolls back to the most recent savepoint
+        // with matching name, so one name serves any nesting level
+        // once savepoints nested deeper are released.
+        "savepoint sqlitepp_txn",
+        "release sqlitepp_txn",
+        "rollback to sqlitepp_txn",
+    };
+
+    assert(c >= 0 && c < control_count);
+    sqlite3_stmt*& st = controls_[c];
+    if ( !st )
+    {
+        // control statements live as long as the session
+        check_error(sqlite3_prepare_v3(impl_, sql[c], -1,
+            SQLITE_PREPARE_PERSISTENT, &st, nullptr));
+    }
+
+    int r = sqlite3_step(st);
+    sqlite3_reset(st);
+
+    // begin and busy commit leave no changes, safe to repeat
+    bool const retry = c == begin_deferred || c == begin_immediate
+        || c == begin_exclusive || c == commit_txn;
+    for (unsigned i = 0; retry && busy_ && (r & 0xff) == SQLITE_BUSY && i < busy_->policy.txn_retries; ++i)
+    {
+        ++busy_->stats.txn_retries;
+        std::this_thread::sleep_for(busy_->delay(static_cast<int>(i)));
+        r = sqlite3_step(st);
+        sqlite3_reset(st);
+    }
+    last_exec_ = false;
+    check_error(r);
+}
+//----------------------------------------------------------------------------
+
+void session::finalize_controls() noexcept
+{
+    for (auto& st : controls_)
+    {
+        sqlite3_finalize(st);
+        st = nullptr;
+    }
+}
+//----------------------------------------------------------------------------
+
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -8,10 +8,20 @@
 #ifndef SQLITEPP_SESSION_HPP_INCLUDED
 #define SQLITEPP_SESSION_HPP_INCLUDED
 
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <memory>
+
 #include "string.hpp"
+#include "busy_policy.hpp"
+#include "metrics.hpp"
 #include "query.hpp"
+#include "session_options.hpp"
+#include "statement_cache.hpp"
 
 struct sqlite3;
+struct sqlite3_stmt;
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -22,8 +32,9 @@ namespace sqlitepp {
 // Database session. Noncopyable.
 class SQLITEPP_API session
 {
-    friend class transaction; // access to active_txn_
-    friend class statement;   // access to last_exec_
+    friend class transaction; // access to active_txn_ and exec_control
+    friend class statement;   // access to last_exec_ and cache_
+    friend class async_session; // access to cancel_
 
 public:
     enum : unsigned
@@ -47,6 +58,9 @@ public:
     // (see SQLite reference at http://sqlite.org/c3ref/c_open_autoproxy.html)
     explicit session(text const& filename, enum encoding encoding, unsigned flags = read | write | create);
 
+    // Create and open session, apply tuning options.
+    session(text const& filename, session_options const& opts, unsigned flags = read | write | create);
+
     session(session const&) = delete;
     session& operator=(session const&) = delete;
 
@@ -64,6 +78,62 @@ public:
     // (see SQLite reference at http://sqlite.org/c3ref/c_open_autoproxy.html)
     void open(text const& filename, enum encoding encoding, unsigned flags = read | write | create);
 
+    // Open database session and apply tuning options. Previous one will be closed.
+    void open(text const& filename, session_options const& opts, unsigned flags = read | write | create);
+
+    // Apply tuning options, all pragmas in one pass.
+    void apply(session_options const& opts);
+
+    // Effective tuning options of main database, read back from pragmas.
+    session_options options() const;
+
+    // Wait for database locked by other connections with backoff policy,
+    // installed with sqlite3_busy_handler and kept on reopen.
+    // Busy transaction begin and commit are retried by the policy.
+    void set_busy_policy(busy_policy const& policy);
+
+    // Remove busy handler, locked database is reported as SQLITE_BUSY at once.
+    void clear_busy_policy();
+
+    // Busy waits since busy policy was set.
+    busy_stats busy_statistics() const;
+
+    // Count and time prepares, steps and binds of statements, off by default.
+    // Could be called from any thread, statements see it on their next call.
+    void enable_timings(bool enable) noexcept;
+
+    // Connection counters and wrapper timings. Call from the thread using
+    // the session, wrapper timings alone are safe to read from any thread.
+    session_metrics metrics() const;
+
+    // Handler of statement full table scans, called with statement text
+    // and its full scan steps. Exceptions propagate from statement exec or reset.
+    typedef std::function<void (text const& sql, unsigned long long steps)> fullscan_handler;
+
+    // Flag statements with more than steps full table scan steps,
+    // counted since the statement was prepared or last flagged.
+    // Statements are checked when their run is done or they are reset,
+    // cached statements keep counting across reuse.
+    void set_fullscan_guard(unsigned long long steps, fullscan_handler handler);
+
+    // Stop flagging full table scans.
+    void clear_fullscan_guard() noexcept;
+
+    // Interrupt running statements, they throw interrupted.
+    // Could be called from any thread while the session is open.
+    void interrupt() noexcept;
+
+    // Statements running past deadline throw deadline_exceeded, checked
+    // with sqlite3_progress_handler every few VM steps. Throws if SQLite is
+    // built with SQLITE_OMIT_PROGRESS_CALLBACK.
+    void set_deadline(std::chrono::steady_clock::time_point deadline);
+
+    // Remove session deadline, statement deadlines stay.
+    void clear_deadline() noexcept;
+
+    // VM steps between deadline checks, 1000 by default.
+    void set_deadline_granularity(int vm_steps);
+
     // Current encoding.
     enum encoding encoding() const noexcept;
 
@@ -74,14 +144,17 @@ public:
     bool is_open() const noexcept;
 
     // Is there an active transaction?
-    // Currently SQLite 3 doesn't support nested transactions.
-    // So we can test, is there any transaction in session.
-    // If we have the transaction, we get it or null otherwise.
+    // If we have the transaction, we get the innermost one or null otherwise.
+    // Outer transactions are available with transaction::parent().
     transaction* active_txn() const noexcept;
 
     // Last statement::exec result
     bool last_exec() const noexcept;
 
+    // Prepared statement cache, used by statement::prepare() and finalize().
+    statement_cache& cache() noexcept;
+    statement_cache const& cache() const noexcept;
+
     /// SQLite implementation for native sqlite3 functions.
     sqlite3* impl() const noexcept;
 
@@ -117,9 +190,77 @@ public:
     }
 
 private:
+    // Transaction control statements, prepared once per session.
+    enum control
+    {
+        begin_deferred,
+        begin_immediate,
+        begin_exclusive,
+        commit_txn,
+        rollback_txn,
+        savepoint_txn,
+        release_txn,
+        rollback_to_txn,
+        control_count
+    };
+
+    // Execute control statement, prepare it on first use.
+    void exec_control(control c);
+
+    // Finalize prepared control statements.
+    void finalize_controls() noexcept;
+
+    // Busy policy state and statistics.
+    struct busy_state;
+    // sqlite3_busy_handler callback.
+    static int on_busy(void* state, int count);
+
+    // sqlite3_progress_handler callback.
+    static int on_progress(void* self);
+    // Install progress handler if there is a deadline or cancellation flag,
+    // remove it otherwise.
+    void watch_deadline() noexcept;
+
+    // Nearest of session and statement deadline while the statement steps.
+    class deadline_scope
+    {
+    public:
+        deadline_scope(session& s, std::chrono::steady_clock::time_point deadline) noexcept;
+        ~deadline_scope();
+    private:
+        session& s_;
+        std::chrono::steady_clock::time_point const saved_;
+    };
+
     sqlite3* impl_;
     transaction* active_txn_;
     bool last_exec_;
+    statement_cache cache_;
+    sqlite3_stmt* controls_[control_count];
+    std::unique_ptr<busy_state> busy_;
+
+    // Wrapper call counters, updated by statements when timings are enabled.
+    struct timings
+    {
+        std::atomic<unsigned long long> prepares, prepare_ns;
+        std::atomic<unsigned long long> steps, step_ns;
+        std::atomic<unsigned long long> binds, bind_ns;
+    };
+    std::atomic<bool> timed_;
+    timings timings_;
+
+    unsigned long long fullscan_steps_;
+    fullscan_handler fullscan_handler_;
+
+    // Session deadline, and deadline checked by the progress handler.
+    std::chrono::steady_clock::time_point deadline_;
+    std::chrono::steady_clock::time_point step_deadline_;
+    int deadline_steps_;
+    // Interrupt was caused by deadline, cleared when reported.
+    mutable bool deadline_hit_;
+    // Cancellation flag of running async_session operation, checked before
+    // statements step and by the progress handler.
+    std::atomic<bool> const* cancel_;
 };
 
 //////////////////////////////////////////////////////////////////////////////
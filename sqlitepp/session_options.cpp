@@ -0,0 +1,65 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include "session_options.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+session_options session_options::bulk_load() noexcept
+{
+    session_options opts;
+    opts.journal = journal_mode::off;
+    opts.sync = synchronous::off;
+    opts.temp = temp_store::memory;
+    opts.cache_size = -256 * 1024;  // 256 MiB
+    return opts;
+}
+//----------------------------------------------------------------------------
+
+session_options session_options::oltp_wal() noexcept
+{
+    session_options opts;
+    opts.journal = journal_mode::wal;
+    // WAL stays consistent without sync on each commit
+    opts.sync = synchronous::normal;
+    opts.temp = temp_store::memory;
+    opts.cache_size = -64 * 1024;   // 64 MiB
+    opts.mmap_size = 256ll << 20;
+    return opts;
+}
+//----------------------------------------------------------------------------
+
+session_options session_options::read_only_analytics() noexcept
+{
+    session_options opts;
+    opts.temp = temp_store::memory;
+    opts.cache_size = -512 * 1024;  // 512 MiB
+    opts.mmap_size = 1ll << 30;
+    opts.query_only = query_only_mode::on;
+    return opts;
+}
+//----------------------------------------------------------------------------
+
+session_options session_options::in_memory() noexcept
+{
+    session_options opts;
+    opts.journal = journal_mode::memory;
+    opts.sync = synchronous::off;
+    opts.temp = temp_store::memory;
+    return opts;
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
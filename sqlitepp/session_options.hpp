@@ -0,0 +1,77 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_SESSION_OPTIONS_HPP_INCLUDED
+#define SQLITEPP_SESSION_OPTIONS_HPP_INCLUDED
+
+#include "fwd.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Connection tuning pragmas, applied together by session::open or
+// session::apply. Default values keep SQLite defaults, no pragma is issued.
+//
+//     session s("app.db", session_options::oltp_wal());
+//
+struct SQLITEPP_API session_options
+{
+    // PRAGMA journal_mode
+    enum class journal_mode { keep, delete_file, truncate, persist, memory, wal, off };
+    // PRAGMA synchronous
+    enum class synchronous { keep, off, normal, full, extra };
+    // PRAGMA temp_store
+    enum class temp_store { keep, file, memory };
+    // PRAGMA query_only
+    enum class query_only_mode { keep, off, on };
+
+    session_options() noexcept
+        : journal(journal_mode::keep)
+        , sync(synchronous::keep)
+        , temp(temp_store::keep)
+        , page_size(0)
+        , cache_size(0)
+        , mmap_size(-1)
+        , query_only(query_only_mode::keep)
+    {
+    }
+
+    journal_mode journal;
+    synchronous sync;
+    temp_store temp;
+    // Page size in bytes of a new database, 0 keeps default.
+    int page_size;
+    // Page cache size, pages if positive, KiB if negative, 0 keeps default.
+    long long cache_size;
+    // Maximal memory mapped size in bytes, 0 disables, -1 keeps default.
+    long long mmap_size;
+    // Reject changes to the database when on.
+    query_only_mode query_only;
+
+    // Loading of large data sets, durability is traded for speed:
+    // no rollback journal, no syncs, large cache.
+    static session_options bulk_load() noexcept;
+    // Concurrent short transactions: WAL, synchronous NORMAL, moderate cache and mmap.
+    static session_options oltp_wal() noexcept;
+    // Long read-only queries: query only, large cache and mmap, temp in memory.
+    static session_options read_only_analytics() noexcept;
+    // In-memory or throwaway databases: journal in memory, no syncs.
+    static session_options in_memory() noexcept;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_SESSION_OPTIONS_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
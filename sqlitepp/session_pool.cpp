@@ -0,0 +1,198 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cassert>
+
+#include "session_pool.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// session_pool::lease
+//
+
+session_pool::lease::lease() noexcept
+    : pool_(nullptr)
+    , group_(nullptr)
+    , s_(nullptr)
+{
+}
+//----------------------------------------------------------------------------
+
+session_pool::lease::lease(session_pool& pool, group& g, session& s) noexcept
+    : pool_(&pool)
+    , group_(&g)
+    , s_(&s)
+    , since_(std::chrono::steady_clock::now())
+{
+}
+//----------------------------------------------------------------------------
+
+session_pool::lease::lease(lease&& src) noexcept
+    : pool_(src.pool_)
+    , group_(src.group_)
+    , s_(src.s_)
+    , since_(src.since_)
+{
+    src.s_ = nullptr;
+}
+//----------------------------------------------------------------------------
+
+session_pool::lease& session_pool::lease::operator=(lease&& src) noexcept
+{
+    if ( this != &src )
+    {
+        release();
+        pool_ = src.pool_;
+        group_ = src.group_;
+        s_ = src.s_;
+        since_ = src.since_;
+        src.s_ = nullptr;
+    }
+    return *this;
+}
+//----------------------------------------------------------------------------
+
+session_pool::lease::~lease()
+{
+    release();
+}
+//----------------------------------------------------------------------------
+
+void session_pool::lease::release() noexcept
+{
+    if ( s_ )
+    {
+        pool_->release(*group_, *s_, since_);
+        s_ = nullptr;
+    }
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+//
+// session_pool
+//
+
+session_pool::session_pool(text const& filename, options const& opts)
+    : created_(std::chrono::steady_clock::now())
+{
+    // writer first, it creates database and may switch journal mode
+    open(writer_, 1, filename, session::read | session::write | session::create, opts);
+    open(readers_, opts.readers, filename, session::read, opts);
+}
+//----------------------------------------------------------------------------
+
+session_pool::~session_pool()
+{
+    assert(writer_.idle.size() == writer_.sessions.size() && "writer is leased");
+    assert(readers_.idle.size() == readers_.sessions.size() && "reader is leased");
+}
+//----------------------------------------------------------------------------
+
+void session_pool::open(group& g, std::size_t count, text const& filename, unsigned flags, options const& opts)
+{
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        std::unique_ptr<session> s(new session(filename, opts.tuning, flags));
+        for (auto const& sql : opts.pragmas)
+        {
+            *s << sql;
+        }
+        g.idle.push_back(s.get());
+        g.sessions.push_back(std::move(s));
+    }
+}
+//----------------------------------------------------------------------------
+
+session_pool::lease session_pool::read()
+{
+    return acquire(readers_.sessions.empty() ? writer_ : readers_);
+}
+//----------------------------------------------------------------------------
+
+session_pool::lease session_pool::write()
+{
+    return acquire(writer_);
+}
+//----------------------------------------------------------------------------
+
+session_pool::lease session_pool::acquire(group& g)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if ( g.idle.empty() )
+    {
+        auto const start = std::chrono::steady_clock::now();
+        g.available.wait(lock, [&g] { return !g.idle.empty(); });
+        auto const wait = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start);
+
+        ++g.waits;
+        g.wait_time += wait;
+        if ( wait > g.max_wait ) g.max_wait = wait;
+    }
+    ++g.leases;
+    session* const s = g.idle.back();
+    g.idle.pop_back();
+    return lease(*this, g, *s);
+}
+//----------------------------------------------------------------------------
+
+void session_pool::release(group& g, session& s, std::chrono::steady_clock::time_point since) noexcept
+{
+    auto const busy = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - since);
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        g.busy_time += busy;
+        // capacity is reserved by open(), push_back does not throw
+        g.idle.push_back(&s);
+    }
+    g.available.notify_one();
+}
+//----------------------------------------------------------------------------
+
+session_pool::stats session_pool::read_stats() const
+{
+    return snapshot(readers_.sessions.empty() ? writer_ : readers_);
+}
+//----------------------------------------------------------------------------
+
+session_pool::stats session_pool::write_stats() const
+{
+    return snapshot(writer_);
+}
+//----------------------------------------------------------------------------
+
+session_pool::stats session_pool::snapshot(group const& g) const
+{
+    auto const lifetime = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - created_);
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    stats st;
+    st.size = g.sessions.size();
+    st.in_use = g.sessions.size() - g.idle.size();
+    st.leases = g.leases;
+    st.waits = g.waits;
+    st.wait_time = g.wait_time;
+    st.max_wait = g.max_wait;
+    st.busy_time = g.busy_time;
+    st.utilization = (st.size && lifetime.count())
+        ? double(g.busy_time.count()) / (double(lifetime.count()) * st.size) : 0.0;
+    return st;
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
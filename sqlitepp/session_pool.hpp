@@ -0,0 +1,156 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_SESSION_POOL_HPP_INCLUDED
+#define SQLITEPP_SESSION_POOL_HPP_INCLUDED
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "session.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Thread-safe pool of sessions to one database file. Noncopyable.
+// There are a number of read-only sessions and one writer session,
+// so readers scale in WAL mode while writes stay serialized.
+// Sessions are handed out as RAII leases, one thread at a time.
+class SQLITEPP_API session_pool
+{
+    struct group;
+
+public:
+    struct options
+    {
+        options() noexcept : readers(4) {}
+
+        // Number of read-only sessions, 0 makes readers share the writer.
+        std::size_t readers;
+        // Tuning options applied on every session after open, before pragmas.
+        session_options tuning;
+        // SQL executed on every session after open, e.g. pragmas.
+        // Applied to the writer first, so it may switch journal mode.
+        std::vector<u8string> pragmas;
+    };
+
+    // Lease statistics of readers or writer.
+    struct stats
+    {
+        // Number of sessions.
+        std::size_t size;
+        // Number of leased sessions.
+        std::size_t in_use;
+        // Number of leases.
+        unsigned long long leases;
+        // Number of leases waited for a free session.
+        unsigned long long waits;
+        // Total and maximal time waited for a free session.
+        std::chrono::nanoseconds wait_time;
+        std::chrono::nanoseconds max_wait;
+        // Total time sessions were leased, for returned leases.
+        std::chrono::nanoseconds busy_time;
+        // Ratio of busy_time to size * pool lifetime.
+        double utilization;
+    };
+
+    // Session lease, returns session to the pool on destroy. Movable.
+    class SQLITEPP_API lease
+    {
+        friend class session_pool;
+
+    public:
+        lease() noexcept;
+        lease(lease&& src) noexcept;
+        lease& operator=(lease&& src) noexcept;
+
+        lease(lease const&) = delete;
+        lease& operator=(lease const&) = delete;
+
+        // Return session to pool on destroy.
+        ~lease();
+
+        // Return session to pool now.
+        void release() noexcept;
+
+        // Is a session leased?
+        explicit operator bool() const noexcept { return s_ != nullptr; }
+
+        session& operator*() const noexcept { return *s_; }
+        session* operator->() const noexcept { return s_; }
+        session* get() const noexcept { return s_; }
+
+    private:
+        lease(session_pool& pool, group& g, session& s) noexcept;
+
+        session_pool* pool_;
+        group* group_;
+        session* s_;
+        std::chrono::steady_clock::time_point since_;
+    };
+
+    // Open writer and reader sessions.
+    explicit session_pool(text const& filename, options const& opts = options());
+
+    session_pool(session_pool const&) = delete;
+    session_pool& operator=(session_pool const&) = delete;
+
+    // Close sessions on destroy. All leases should be returned.
+    ~session_pool();
+
+    // Lease a read-only session, wait until one is free.
+    lease read();
+
+    // Lease the writer session, wait until it is free.
+    lease write();
+
+    // Statistics of read-only sessions.
+    stats read_stats() const;
+
+    // Statistics of the writer session.
+    stats write_stats() const;
+
+private:
+    struct group
+    {
+        std::vector<std::unique_ptr<session>> sessions;
+        std::vector<session*> idle;
+        std::condition_variable available;
+
+        unsigned long long leases = 0;
+        unsigned long long waits = 0;
+        std::chrono::nanoseconds wait_time{0};
+        std::chrono::nanoseconds max_wait{0};
+        std::chrono::nanoseconds busy_time{0};
+    };
+
+    void open(group& g, std::size_t count, text const& filename, unsigned flags, options const& opts);
+    lease acquire(group& g);
+    void release(group& g, session& s, std::chrono::steady_clock::time_point since) noexcept;
+    stats snapshot(group const& g) const;
+
+    mutable std::mutex mutex_;
+    group writer_;
+    group readers_;
+    std::chrono::steady_clock::time_point const created_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_SESSION_POOL_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
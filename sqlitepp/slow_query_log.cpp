@@ -0,0 +1,209 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <sqlite3.h>
+
+#include "slow_query_log.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+slow_query_log::slow_query_log(session& s, std::chrono::nanoseconds threshold, options const& opts)
+    : s_(s)
+    , threshold_(threshold)
+    , opts_(opts)
+    , ring_(opts.capacity ? opts.capacity : 1)
+    , head_(0)
+    , tail_(0)
+    , dropped_(0)
+    , explaining_(false)
+{
+    s_.check_error( sqlite3_trace_v2(s_.impl(), SQLITE_TRACE_STMT | SQLITE_TRACE_PROFILE, on_trace, this) );
+}
+//----------------------------------------------------------------------------
+
+slow_query_log::~slow_query_log()
+{
+    sqlite3_trace_v2(s_.impl(), 0, nullptr, nullptr);
+}
+//----------------------------------------------------------------------------
+
+int slow_query_log::on_trace(unsigned type, void* self, void* p, void* x)
+{
+    slow_query_log& log = *static_cast<slow_query_log*>(self);
+    if ( log.explaining_ )
+    {
+        return 0;
+    }
+    sqlite3_stmt* const stmt = static_cast<sqlite3_stmt*>(p);
+    if ( type == SQLITE_TRACE_STMT )
+    {
+        // trigger programs are traced as "-- trigger name"
+        char const* const sql = static_cast<char const*>(x);
+        if ( !(sql && sql[0] == '-' && sql[1] == '-') )
+        {
+            log.started(stmt);
+        }
+    }
+    else if ( type == SQLITE_TRACE_PROFILE )
+    {
+        log.profiled(stmt, *static_cast<sqlite3_int64 const*>(x));
+    }
+    return 0;
+}
+//----------------------------------------------------------------------------
+
+void slow_query_log::started(sqlite3_stmt* stmt)
+{
+    started_[stmt] = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 0);
+}
+//----------------------------------------------------------------------------
+
+void slow_query_log::profiled(sqlite3_stmt* stmt, long long ns)
+{
+    int start = 0;
+    auto const it = started_.find(stmt);
+    if ( it != started_.end() )
+    {
+        start = it->second;
+        started_.erase(it);
+    }
+    if ( std::chrono::nanoseconds(ns) < threshold_ )
+    {
+        return;
+    }
+
+    std::size_t const head = head_.load(std::memory_order_relaxed);
+    if ( head - tail_.load(std::memory_order_acquire) >= ring_.size() )
+    {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    record& r = ring_[head % ring_.size()];
+    char const* const sql = sqlite3_sql(stmt);
+    r.normalized_sql.assign(sql ? sql : "");
+    if ( char* const expanded = sqlite3_expanded_sql(stmt) )
+    {
+        r.sql.assign(expanded);
+        sqlite3_free(expanded);
+    }
+    else
+    {
+        // too long or out of memory
+        r.sql = r.normalized_sql;
+    }
+    r.plan = plan(sql);
+    // counter could be reset by statement::metrics in the meantime
+    int const steps = sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_VM_STEP, 0);
+    r.steps = static_cast<unsigned long long>(steps >= start ? steps - start : steps);
+    r.duration = std::chrono::nanoseconds(ns);
+
+    head_.store(head + 1, std::memory_order_release);
+}
+//----------------------------------------------------------------------------
+
+std::shared_ptr<std::string const> slow_query_log::plan(char const* sql)
+{
+    if ( !sql || opts_.max_plans == 0 )
+    {
+        return nullptr;
+    }
+    std::string key(sql);
+    auto const found = plan_index_.find(key);
+    if ( found != plan_index_.end() )
+    {
+        plans_.splice(plans_.begin(), plans_, found->second);
+        return found->second->second;
+    }
+
+    std::shared_ptr<std::string const> text = explain(sql);
+    plans_.emplace_front(key, text);
+    plan_index_.emplace(std::move(key), plans_.begin());
+    if ( plans_.size() > opts_.max_plans )
+    {
+        // records keep their plans
+        plan_index_.erase(plans_.back().first);
+        plans_.pop_back();
+    }
+    return text;
+}
+//----------------------------------------------------------------------------
+
+std::shared_ptr<std::string const> slow_query_log::explain(char const* sql)
+{
+    std::string const query = std::string("explain query plan ") + sql;
+    std::shared_ptr<std::string> text = std::make_shared<std::string>();
+    sqlite3_stmt* stmt = nullptr;
+    explaining_ = true;
+    if ( sqlite3_prepare_v2(s_.impl(), query.c_str(), -1, &stmt, nullptr) == SQLITE_OK && stmt )
+    {
+        // rows are id, parent, notused, detail; parents come first
+        std::unordered_map<int, int> depths;
+        while ( sqlite3_step(stmt) == SQLITE_ROW )
+        {
+            int const id = sqlite3_column_int(stmt, 0);
+            auto const parent = depths.find(sqlite3_column_int(stmt, 1));
+            int const depth = parent != depths.end() ? parent->second + 1 : 0;
+            depths[id] = depth;
+
+            char const* const detail = reinterpret_cast<char const*>(sqlite3_column_text(stmt, 3));
+            text->append(2 * depth, ' ');
+            text->append(detail ? detail : "");
+            text->push_back('\n');
+        }
+    }
+    sqlite3_finalize(stmt);
+    explaining_ = false;
+    return text;
+}
+//----------------------------------------------------------------------------
+
+slow_query_log::record* slow_query_log::front() noexcept
+{
+    std::size_t const tail = tail_.load(std::memory_order_relaxed);
+    if ( tail == head_.load(std::memory_order_acquire) )
+    {
+        return nullptr;
+    }
+    return &ring_[tail % ring_.size()];
+}
+//----------------------------------------------------------------------------
+
+void slow_query_log::pop() noexcept
+{
+    std::size_t const tail = tail_.load(std::memory_order_relaxed);
+    tail_.store(tail + 1, std::memory_order_release);
+}
+//----------------------------------------------------------------------------
+
+std::size_t slow_query_log::drain(std::vector<record>& out)
+{
+    std::size_t count = 0;
+    for (record* r; (r = front()) != nullptr; ++count)
+    {
+        out.push_back(std::move(*r));
+        pop();
+    }
+    return count;
+}
+//----------------------------------------------------------------------------
+
+unsigned long long slow_query_log::dropped() const noexcept
+{
+    return dropped_.load(std::memory_order_relaxed);
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,152 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_SLOW_QUERY_LOG_HPP_INCLUDED
+#define SQLITEPP_SLOW_QUERY_LOG_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "session.hpp"
+
+struct sqlite3_stmt;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Log of statement runs slower than a threshold. Noncopyable.
+// Runs are profiled with sqlite3_trace_v2 while the log exists, a session
+// without log has no tracing overhead. Records are put into a lock-free
+// ring buffer by the thread using the session, and can be drained by one
+// other thread at a time. Records are dropped while the buffer is full.
+// The log replaces other sqlite3_trace_v2 callbacks of the session.
+//
+//     slow_query_log log(s, std::chrono::milliseconds(10));
+//     ...
+//     log.drain([](slow_query_log::record const& r) { std::clog << r.sql << '\n'; });
+//
+class SQLITEPP_API slow_query_log
+{
+public:
+    // Slow statement run.
+    struct record
+    {
+        // Statement text with parameters expanded to bound values.
+        std::string sql;
+        // Statement text as prepared, with parameters.
+        std::string normalized_sql;
+        // EXPLAIN QUERY PLAN rows, one per line indented by depth,
+        // captured once per cached statement text and shared by its records.
+        // Null if plans are disabled.
+        std::shared_ptr<std::string const> plan;
+        // Virtual machine operations of the run.
+        unsigned long long steps;
+        // Wall time of the run.
+        std::chrono::nanoseconds duration;
+    };
+
+    struct options
+    {
+        options() noexcept
+            : capacity(1024)
+            , max_plans(256)
+        {
+        }
+
+        // Number of records in the ring buffer.
+        std::size_t capacity;
+        // Number of cached plans, the least recently used one is dropped
+        // and captured again when needed. 0 disables plans.
+        std::size_t max_plans;
+    };
+
+    // Log runs of session statements taking threshold or longer, zero logs
+    // all runs. Session must be open until the log is destroyed.
+    slow_query_log(session& s, std::chrono::nanoseconds threshold, options const& opts = options());
+
+    slow_query_log(slow_query_log const&) = delete;
+    slow_query_log& operator=(slow_query_log const&) = delete;
+
+    // Stop tracing the session.
+    ~slow_query_log();
+
+    // Move buffered records into out, return number of records moved.
+    std::size_t drain(std::vector<record>& out);
+
+    // Call f(record const&) for each buffered record and remove them,
+    // return number of records.
+    template<typename F>
+    std::size_t drain(F f)
+    {
+        std::size_t count = 0;
+        for (record* r; (r = front()) != nullptr; ++count)
+        {
+            f(static_cast<record const&>(*r));
+            pop();
+        }
+        return count;
+    }
+
+    // Number of records dropped because the buffer was full.
+    unsigned long long dropped() const noexcept;
+
+    // Latency threshold.
+    std::chrono::nanoseconds threshold() const noexcept { return threshold_; }
+
+private:
+    // sqlite3_trace_v2 callback.
+    static int on_trace(unsigned type, void* self, void* p, void* x);
+
+    // Remember VM step count at run start.
+    void started(sqlite3_stmt* stmt);
+    // Record slow run.
+    void profiled(sqlite3_stmt* stmt, long long ns);
+    // EXPLAIN QUERY PLAN of sql, cached by text.
+    std::shared_ptr<std::string const> plan(char const* sql);
+    // Capture EXPLAIN QUERY PLAN of sql.
+    std::shared_ptr<std::string const> explain(char const* sql);
+
+    // Oldest buffered record, null if empty. Consumer side.
+    record* front() noexcept;
+    // Remove oldest record. Consumer side.
+    void pop() noexcept;
+
+    session& s_;
+    std::chrono::nanoseconds const threshold_;
+    options const opts_;
+    // Ring of slots, head_ is written by producer, tail_ by consumer.
+    std::vector<record> ring_;
+    std::atomic<std::size_t> head_;
+    std::atomic<std::size_t> tail_;
+    std::atomic<unsigned long long> dropped_;
+    // VM step count at start of running statements.
+    std::unordered_map<sqlite3_stmt*, int> started_;
+    // Plans by statement text, most recently used first.
+    typedef std::list<std::pair<std::string, std::shared_ptr<std::string const>>> plan_list;
+    plan_list plans_;
+    std::unordered_map<std::string, plan_list::iterator> plan_index_;
+    // Capturing plan, its statement must not be traced.
+    bool explaining_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_SLOW_QUERY_LOG_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
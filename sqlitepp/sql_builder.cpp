@@ -0,0 +1,172 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <clocale>
+#include <cstdio>
+#include <sstream>
+
+#include "sql_builder.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+sql_builder::sql_builder() noexcept
+    : data_(inline_)
+    , size_(0)
+    , capacity_(inline_capacity)
+{
+    inline_[0] = '\0';
+}
+//----------------------------------------------------------------------------
+
+sql_builder::sql_builder(sql_builder&& src) noexcept
+    : sql_builder()
+{
+    swap(src);
+}
+//----------------------------------------------------------------------------
+
+sql_builder& sql_builder::operator=(sql_builder&& src) noexcept
+{
+    if ( this != &src )
+    {
+        sql_builder().swap(*this);
+        swap(src);
+    }
+    return *this;
+}
+//----------------------------------------------------------------------------
+
+sql_builder::~sql_builder()
+{
+    if ( data_ != inline_ )
+    {
+        delete[] data_;
+    }
+}
+//----------------------------------------------------------------------------
+
+void sql_builder::swap(sql_builder& other) noexcept
+{
+    bool const this_inline = data_ == inline_;
+    bool const other_inline = other.data_ == other.inline_;
+
+    // inline texts always fit to the other's inline storage
+    char tmp[inline_capacity];
+    if ( this_inline ) std::memcpy(tmp, inline_, size_ + 1);
+    if ( other_inline ) std::memcpy(inline_, other.inline_, other.size_ + 1);
+    if ( this_inline ) std::memcpy(other.inline_, tmp, size_ + 1);
+
+    std::swap(data_, other.data_);
+    std::swap(size_, other.size_);
+    std::swap(capacity_, other.capacity_);
+    std::swap(fmt_, other.fmt_);
+
+    if ( this_inline ) other.data_ = other.inline_;
+    if ( other_inline ) data_ = inline_;
+}
+//----------------------------------------------------------------------------
+
+void sql_builder::clear() noexcept
+{
+    size_ = 0;
+    data_[0] = '\0';
+    fmt_.reset();
+}
+//----------------------------------------------------------------------------
+
+void sql_builder::grow(std::size_t n)
+{
+    std::size_t capacity = capacity_ * 2;
+    if ( capacity < n + 1 ) capacity = n + 1;
+
+    char* const data = new char[capacity];
+    std::memcpy(data, data_, size_ + 1);
+    if ( data_ != inline_ )
+    {
+        delete[] data_;
+    }
+    data_ = data;
+    capacity_ = capacity;
+}
+//----------------------------------------------------------------------------
+
+void sql_builder::write_unsigned(unsigned long long v)
+{
+    char buf[24];
+    char* const end = buf + sizeof(buf);
+    char* p = end;
+    do
+    {
+        *--p = static_cast<char>('0' + v % 10);
+        v /= 10;
+    } while ( v );
+    append(p, end - p);
+}
+//----------------------------------------------------------------------------
+
+void sql_builder::write_signed(long long v)
+{
+    if ( v < 0 )
+    {
+        append("-", 1);
+        // negate in unsigned arithmetic, safe for the minimal value
+        write_unsigned(0ull - static_cast<unsigned long long>(v));
+    }
+    else
+    {
+        write_unsigned(static_cast<unsigned long long>(v));
+    }
+}
+//----------------------------------------------------------------------------
+
+void sql_builder::write_real(double v)
+{
+    // same as std::ostream default: %g with precision 6
+    char buf[32];
+    int const n = std::snprintf(buf, sizeof(buf), "%.6g", v);
+    if ( n <= 0 )
+    {
+        return;
+    }
+
+    // SQL always uses '.' regardless of C locale
+    char const point = *std::localeconv()->decimal_point;
+    if ( point != '.' )
+    {
+        for (int i = 0; i < n; ++i) if ( buf[i] == point ) buf[i] = '.';
+    }
+    append(buf, n);
+}
+//----------------------------------------------------------------------------
+
+std::ostream& sql_builder::stream()
+{
+    if ( !fmt_ )
+    {
+        fmt_.reset(new std::ostringstream);
+    }
+    return *fmt_;
+}
+//----------------------------------------------------------------------------
+
+void sql_builder::flush()
+{
+    std::string const s = fmt_->str();
+    append(s.data(), s.size());
+    fmt_->str(std::string());
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,170 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_SQL_BUILDER_HPP_INCLUDED
+#define SQLITEPP_SQL_BUILDER_HPP_INCLUDED
+
+#include <cstring>
+#include <memory>
+#include <ostream>
+#include <type_traits>
+
+#include "string.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// SQL text builder with inline storage for short statements. Noncopyable.
+// Strings and arithmetic values are appended without std::ostream.
+// Other types are formatted by an output stream created on first use,
+// which formats arithmetic values then as well, to keep its manipulators.
+class SQLITEPP_API sql_builder
+{
+public:
+    // Create an empty builder.
+    sql_builder() noexcept;
+    sql_builder(sql_builder&& src) noexcept;
+    sql_builder& operator=(sql_builder&& src) noexcept;
+
+    sql_builder(sql_builder const&) = delete;
+    sql_builder& operator=(sql_builder const&) = delete;
+
+    ~sql_builder();
+
+    void swap(sql_builder& other) noexcept;
+
+    // Built nul-terminated SQL text, valid until the builder is changed.
+    text str() const noexcept { return text(data_, size_); }
+
+    // Length of SQL text.
+    std::size_t size() const noexcept { return size_; }
+
+    // Is SQL text empty?
+    bool empty() const noexcept { return size_ == 0; }
+
+    // Clear SQL text and reset stream formatting.
+    void clear() noexcept;
+
+    // Append n chars.
+    void append(char const* s, std::size_t n)
+    {
+        if ( size_ + n >= capacity_ ) grow(size_ + n);
+        std::memcpy(data_ + size_, s, n);
+        size_ += n;
+        data_[size_] = '\0';
+    }
+
+    sql_builder& operator<<(text const& t)
+    {
+        append(t.data, t.size != std::size_t(-1) ? t.size : t.data ? std::strlen(t.data) : 0);
+        return *this;
+    }
+
+    sql_builder& operator<<(u8string const& s)
+    {
+        append(s.data(), s.size());
+        return *this;
+    }
+
+    sql_builder& operator<<(char const* s)
+    {
+        // the length of a literal is folded at compile time
+        append(s, std::strlen(s));
+        return *this;
+    }
+
+    // Append value of any output-stream-shiftable type.
+    template<typename T>
+    sql_builder& operator<<(T const& t)
+    {
+        write(t, kind_of<T>());
+        return *this;
+    }
+
+private:
+    enum kind { other_kind, char_kind, signed_kind, unsigned_kind, real_kind };
+
+    template<typename T, typename... U> struct any_of : std::false_type {};
+    template<typename T, typename U, typename... V>
+    struct any_of<T, U, V...> : std::integral_constant<bool,
+        std::is_same<T, U>::value || any_of<T, V...>::value> {};
+
+    template<typename T>
+    struct kind_of : std::integral_constant<kind,
+        any_of<T, char, signed char, unsigned char>::value ? char_kind :
+        any_of<T, bool, short, int, long, long long>::value ? signed_kind :
+        any_of<T, unsigned short, unsigned int, unsigned long, unsigned long long>::value ? unsigned_kind :
+        any_of<T, float, double>::value ? real_kind : other_kind> {};
+
+    template<typename T>
+    void write(T const& t, std::integral_constant<kind, other_kind>)
+    {
+        stream() << t;
+        flush();
+    }
+
+    template<typename T>
+    void write(T const& t, std::integral_constant<kind, char_kind>)
+    {
+        char const c = static_cast<char>(t);
+        append(&c, 1);
+    }
+
+    template<typename T>
+    void write(T const& t, std::integral_constant<kind, signed_kind>)
+    {
+        if ( fmt_ ) write(t, std::integral_constant<kind, other_kind>());
+        else write_signed(t);
+    }
+
+    template<typename T>
+    void write(T const& t, std::integral_constant<kind, unsigned_kind>)
+    {
+        if ( fmt_ ) write(t, std::integral_constant<kind, other_kind>());
+        else write_unsigned(t);
+    }
+
+    template<typename T>
+    void write(T const& t, std::integral_constant<kind, real_kind>)
+    {
+        if ( fmt_ ) write(t, std::integral_constant<kind, other_kind>());
+        else write_real(t);
+    }
+
+    void write_signed(long long v);
+    void write_unsigned(unsigned long long v);
+    void write_real(double v);
+
+    // Formatting stream for other types, created on first use.
+    std::ostream& stream();
+    // Move stream content to the buffer.
+    void flush();
+
+    // Make room for n chars and the nul-terminator.
+    void grow(std::size_t n);
+
+    enum { inline_capacity = 128 };
+
+    char* data_;
+    std::size_t size_;
+    std::size_t capacity_;
+    char inline_[inline_capacity];
+    std::unique_ptr<std::ostringstream> fmt_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_SQL_BUILDER_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
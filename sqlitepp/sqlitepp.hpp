@@ -17,9 +17,22 @@
 // include library headers
 #include "string.hpp"
 #include "exception.hpp"
+#include "async_session.hpp"
+#include "busy_policy.hpp"
 #include "session.hpp"
+#include "session_options.hpp"
+#include "blob_stream.hpp"
+#include "bulk_insert.hpp"
+#include "checkpoint_scheduler.hpp"
+#include "metrics.hpp"
+#include "slow_query_log.hpp"
+#include "session_pool.hpp"
 #include "statement.hpp"
+#include "statement_cache.hpp"
 #include "transaction.hpp"
+#include "typed_statement.hpp"
+#include "write_batcher.hpp"
+#include "columns.hpp"
 #include "into.hpp"
 #include "use.hpp"
 #include "converters.hpp"
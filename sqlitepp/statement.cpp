@@ -5,6 +5,9 @@
 // Boost Software License, Version 1.0. (See accompanying file
 // LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <cstring>
 
 #include <sqlite3.h>
@@ -12,6 +15,7 @@
 #include "statement.hpp"
 #include "exception.hpp"
 #include "binders.hpp"
+#include "columns.hpp"
 #include "session.hpp"
 
 //////////////////////////////////////////////////////////////////////////////
@@ -20,9 +24,75 @@ namespace sqlitepp {
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+// Count call and its time on destroy, if enabled.
+class call_timer
+{
+public:
+    call_timer(bool enabled, std::atomic<unsigned long long>& calls, std::atomic<unsigned long long>& ns) noexcept
+        : calls_(enabled ? &calls : nullptr)
+        , ns_(ns)
+    {
+        if ( calls_ ) start_ = std::chrono::steady_clock::now();
+    }
+
+    ~call_timer()
+    {
+        if ( calls_ )
+        {
+            std::chrono::nanoseconds const elapsed = std::chrono::steady_clock::now() - start_;
+            calls_->fetch_add(1, std::memory_order_relaxed);
+            ns_.fetch_add(elapsed.count(), std::memory_order_relaxed);
+        }
+    }
+
+private:
+    std::atomic<unsigned long long>* calls_;
+    std::atomic<unsigned long long>& ns_;
+    std::chrono::steady_clock::time_point start_;
+};
+
+// Number of times stmt was reprepared after schema change, 0 if not counted.
+inline int reprepare_count(sqlite3_stmt* stmt) noexcept
+{
+#ifdef SQLITE_STMTSTATUS_REPREPARE
+    // empty SQL text is prepared to null
+    return stmt ? sqlite3_stmt_status(stmt, SQLITE_STMTSTATUS_REPREPARE, 0) : 0;
+#else
+    (void)stmt;
+    return 0;
+#endif
+}
+
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+// Scan status value of loop, false if there is no such loop.
+template<typename T>
+bool scan_value(sqlite3_stmt* stmt, int loop, int op, T* value)
+{
+#if SQLITE_VERSION_NUMBER >= 3042000
+    return sqlite3_stmt_scanstatus_v2(stmt, loop, op, 0, value) == 0;
+#else
+    return sqlite3_stmt_scanstatus(stmt, loop, op, value) == 0;
+#endif
+}
+#endif
+
+} // namespace
+
+//////////////////////////////////////////////////////////////////////////////
+
 statement::statement(session& s) noexcept
     : s_(s)
     , impl_(nullptr)
+    , columns_(0)
+    , row_(false)
+    , generation_(1)
+    , reprepares_(0)
+    , fullscan_base_(0)
+    , deadline_(std::chrono::steady_clock::time_point::max())
+    , timeout_(0)
+    , run_deadline_(std::chrono::steady_clock::time_point::max())
 {
 }
 //----------------------------------------------------------------------------
@@ -38,8 +108,21 @@ statement::statement(statement&& src) noexcept
     : s_(src.s_)
     , q_(std::move(src.q_))
     , impl_(src.impl_)
+    , columns_(src.columns_)
+    , row_(src.row_)
+    , names_(std::move(src.names_))
+    , generation_(src.generation_)
+    , reprepares_(src.reprepares_)
+    , fullscan_base_(src.fullscan_base_)
+    , views_(std::move(src.views_))
+    , owned_(std::move(src.owned_))
+    , deadline_(src.deadline_)
+    , timeout_(src.timeout_)
+    , run_deadline_(src.run_deadline_)
 {
     src.impl_ = nullptr;
+    src.columns_ = 0;
+    src.row_ = false;
 }
 //----------------------------------------------------------------------------
 
@@ -53,28 +136,45 @@ void statement::prepare()
 {
     try
     {
-        char const* tail = nullptr;
-        std::string const sql = q_.sql();
-        s_.check_error(sqlite3_prepare_v2(s_.impl(), sql.c_str(),
-                (int)sql.size() + 1, // nByte is the number of bytes in the input string including the nul-terminator.
-                &impl_, &tail));
-        if ( tail && *tail )
+        struct text const sql = q_.sql_text();
         {
-            throw multi_stmt_not_supported();
+            call_timer const timer(s_.timed_.load(std::memory_order_relaxed), s_.timings_.prepares, s_.timings_.prepare_ns);
+            fullscan_base_ = 0;
+            impl_ = s_.cache_.acquire(sql, fullscan_base_);
+            if ( !impl_ )
+            {
+                char const* tail = nullptr;
+                s_.check_error(sqlite3_prepare_v2(s_.impl(), sql.data,
+                        (int)sql.size + 1, // nByte is the number of bytes in the input string including the nul-terminator.
+                        &impl_, &tail));
+                if ( tail && *tail )
+                {
+                    throw multi_stmt_not_supported();
+                }
+            }
         }
+        columns_ = sqlite3_column_count(impl_);
+        reprepares_ = reprepare_count(impl_);
+        row_ = false;
+        names_.clear();
+        owned_.clear();
+        ++generation_;
 
         int index = 0;
         // bind into binders
-        for (auto& i : q_.intos_) index = 1 + i->bind(*this, index);
+        for (into_binder& i : q_.intos_) index = 1 + i.bind(*this, index);
 
         // bind use binders
+        call_timer const timer(s_.timed_.load(std::memory_order_relaxed) && q_.uses_.first, s_.timings_.binds, s_.timings_.bind_ns);
         index = 1;
-        for (auto& u : q_.uses_) index = 1 + u->bind(*this, index);
+        for (use_binder& u : q_.uses_) index = 1 + bind(u, index);
     }
     catch (...)
     {
-        // statement stays not prepared
-        finalize(false);
+        // statement stays not prepared, keep it out of the cache
+        sqlite3_finalize(impl_);
+        impl_ = nullptr;
+        columns_ = 0;
         throw;
     }
 }
@@ -88,16 +188,56 @@ bool statement::exec()
     }
     try
     {
-        int const r = sqlite3_step(impl_);
+        views_.clear();
+        bool const new_run = !row_;
+        int r;
+        s_.deadline_hit_ = false;
+        if ( s_.cancel_ && *s_.cancel_ )
+        {
+            // interrupt before the step starts would be lost
+            throw interrupted();
+        }
+        if ( deadline_ != std::chrono::steady_clock::time_point::max() || timeout_.count() )
+        {
+            if ( new_run )
+            {
+                run_deadline_ = timeout_.count()
+                    ? std::chrono::steady_clock::now() + std::chrono::duration_cast<std::chrono::steady_clock::duration>(timeout_)
+                    : std::chrono::steady_clock::time_point::max();
+            }
+            call_timer const timer(s_.timed_.load(std::memory_order_relaxed), s_.timings_.steps, s_.timings_.step_ns);
+            session::deadline_scope const scope(s_, std::min(deadline_, run_deadline_));
+            r = sqlite3_step(impl_);
+        }
+        else
+        {
+            call_timer const timer(s_.timed_.load(std::memory_order_relaxed), s_.timings_.steps, s_.timings_.step_ns);
+            r = sqlite3_step(impl_);
+        }
+        row_ = (r == SQLITE_ROW);
+        if ( new_run && (r == SQLITE_ROW || r == SQLITE_DONE) )
+        {
+            // statement could be reprepared by the first step after schema change,
+            // column names could change with the same count
+            int const reprepares = reprepare_count(impl_);
+            if ( reprepares != reprepares_ || columns_ != sqlite3_column_count(impl_) )
+            {
+                reprepares_ = reprepares;
+                columns_ = sqlite3_column_count(impl_);
+                names_.clear();
+                ++generation_;
+            }
+        }
         switch ( r )
         {
         case SQLITE_ROW:
             s_.last_exec_ = true;
             // statement has result (select for ex.) - update into holders
-            for (auto& i : q_.intos_) i->update(*this);
+            for (into_binder& i : q_.intos_) update(i);
             break;
         case SQLITE_DONE:
             s_.last_exec_ = false;
+            check_fullscan();
             break;
         default:
             s_.last_exec_ = false;
@@ -114,16 +254,285 @@ bool statement::exec()
 }
 //----------------------------------------------------------------------------
 
+statement_metrics statement::metrics(bool reset) const
+{
+    statement_metrics m = statement_metrics();
+    if ( !impl_ )
+    {
+        return m;
+    }
+
+    struct status { int op; unsigned long long statement_metrics::* value; };
+    static status const statuses[] =
+    {
+        { SQLITE_STMTSTATUS_FULLSCAN_STEP, &statement_metrics::fullscan_steps },
+        { SQLITE_STMTSTATUS_SORT, &statement_metrics::sorts },
+        { SQLITE_STMTSTATUS_AUTOINDEX, &statement_metrics::autoindex_rows },
+        { SQLITE_STMTSTATUS_VM_STEP, &statement_metrics::vm_steps },
+#ifdef SQLITE_STMTSTATUS_REPREPARE
+        { SQLITE_STMTSTATUS_REPREPARE, &statement_metrics::reprepares },
+        { SQLITE_STMTSTATUS_RUN, &statement_metrics::runs },
+#endif
+#ifdef SQLITE_STMTSTATUS_FILTER_HIT
+        { SQLITE_STMTSTATUS_FILTER_MISS, &statement_metrics::filter_misses },
+        { SQLITE_STMTSTATUS_FILTER_HIT, &statement_metrics::filter_hits },
+#endif
+    };
+    for (status const& s : statuses)
+    {
+        m.*s.value = static_cast<unsigned long long>(sqlite3_stmt_status(impl_, s.op, reset ? 1 : 0));
+    }
+    if ( reset )
+    {
+        // compared by exec to notice reprepares and full scans
+        reprepares_ = 0;
+        fullscan_base_ = 0;
+    }
+#ifdef SQLITE_STMTSTATUS_MEMUSED
+    // a size, never reset
+    m.memory_used = static_cast<unsigned long long>(sqlite3_stmt_status(impl_, SQLITE_STMTSTATUS_MEMUSED, 0));
+#endif
+    return m;
+}
+//----------------------------------------------------------------------------
+
+std::vector<scan_loop> statement::scan_status(bool reset) const
+{
+    std::vector<scan_loop> loops;
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+    if ( !impl_ )
+    {
+        return loops;
+    }
+
+    sqlite3_int64 nloop = 0;
+    for (int i = 0; scan_value(impl_, i, SQLITE_SCANSTAT_NLOOP, &nloop); ++i)
+    {
+        scan_loop loop = scan_loop();
+        loop.loops = static_cast<unsigned long long>(nloop);
+
+        sqlite3_int64 nvisit = 0;
+        scan_value(impl_, i, SQLITE_SCANSTAT_NVISIT, &nvisit);
+        loop.rows_visited = static_cast<unsigned long long>(nvisit);
+        scan_value(impl_, i, SQLITE_SCANSTAT_EST, &loop.estimated_rows);
+
+        loop.parent_id = -1;
+        scan_value(impl_, i, SQLITE_SCANSTAT_SELECTID, &loop.select_id);
+#if SQLITE_VERSION_NUMBER >= 3042000
+        scan_value(impl_, i, SQLITE_SCANSTAT_PARENTID, &loop.parent_id);
+#endif
+
+        char const* name = nullptr;
+        if ( scan_value(impl_, i, SQLITE_SCANSTAT_NAME, &name) && name ) loop.name = name;
+        char const* explain = nullptr;
+        if ( scan_value(impl_, i, SQLITE_SCANSTAT_EXPLAIN, &explain) && explain ) loop.explain = explain;
+
+        loops.push_back(std::move(loop));
+    }
+    if ( reset )
+    {
+        sqlite3_stmt_scanstatus_reset(impl_);
+    }
+#else
+    (void)reset;
+#endif
+    return loops;
+}
+//----------------------------------------------------------------------------
+
+bool statement::has_scan_status() noexcept
+{
+#ifdef SQLITE_ENABLE_STMT_SCANSTATUS
+    return true;
+#else
+    return false;
+#endif
+}
+//----------------------------------------------------------------------------
+
+void statement::set_deadline(std::chrono::steady_clock::time_point deadline)
+{
+#ifdef SQLITE_OMIT_PROGRESS_CALLBACK
+    (void)deadline;
+    throw exception(SQLITE_MISUSE, "deadlines need SQLite built without SQLITE_OMIT_PROGRESS_CALLBACK");
+#else
+    deadline_ = deadline;
+#endif
+}
+//----------------------------------------------------------------------------
+
+void statement::set_timeout(std::chrono::nanoseconds timeout)
+{
+#ifdef SQLITE_OMIT_PROGRESS_CALLBACK
+    (void)timeout;
+    throw exception(SQLITE_MISUSE, "deadlines need SQLite built without SQLITE_OMIT_PROGRESS_CALLBACK");
+#else
+    timeout_ = timeout;
+#endif
+}
+//----------------------------------------------------------------------------
+
+void statement::clear_deadline() noexcept
+{
+    deadline_ = std::chrono::steady_clock::time_point::max();
+    timeout_ = std::chrono::nanoseconds(0);
+}
+//----------------------------------------------------------------------------
+
+void statement::check_fullscan()
+{
+    if ( s_.fullscan_handler_ )
+    {
+        // SQLite counter is not reset, metrics() reports it
+        int const steps = sqlite3_stmt_status(impl_, SQLITE_STMTSTATUS_FULLSCAN_STEP, 0);
+        if ( steps < fullscan_base_ )
+        {
+            // counter was reset by a reprepare
+            fullscan_base_ = 0;
+        }
+        if ( steps > fullscan_base_ && static_cast<unsigned long long>(steps - fullscan_base_) > s_.fullscan_steps_ )
+        {
+            // flag on the next growth past the threshold
+            unsigned long long const scanned = static_cast<unsigned long long>(steps - fullscan_base_);
+            fullscan_base_ = steps;
+            s_.fullscan_handler_(sqlite3_sql(impl_), scanned);
+        }
+    }
+}
+//----------------------------------------------------------------------------
+
+std::size_t statement::fetch(std::size_t n)
+{
+    if ( !is_prepared() )
+    {
+        prepare();
+    }
+    for (into_binder& i : q_.intos_) i.reserve(n);
+
+    std::size_t rows = 0;
+    while ( rows < n && exec() )
+    {
+        ++rows;
+    }
+    return rows;
+}
+//----------------------------------------------------------------------------
+
 void statement::reset(bool rebind)
 {
     if ( is_prepared() )
     {
+        row_ = false;
+        views_.clear();
         s_.check_error( sqlite3_reset(impl_) );
+        check_fullscan();
         if ( rebind )
         {
+            call_timer const timer(s_.timed_.load(std::memory_order_relaxed), s_.timings_.binds, s_.timings_.bind_ns);
             int index = 1;
-            for (auto& u : q_.uses_) index = 1 + u->bind(*this, index);
+            for (use_binder& u : q_.uses_) index = 1 + bind(u, index);
+        }
+    }
+}
+//----------------------------------------------------------------------------
+
+int statement::bind(use_binder& u, int pos)
+{
+    auto const& s = u.scalar_;
+    if ( s.pos > 0 ) pos = s.pos;
+    switch ( s.kind )
+    {
+    case scalar_kind::int32:
+        use_value(pos, *static_cast<int const*>(s.value));
+        return pos;
+    case scalar_kind::int64:
+        use_value(pos, *static_cast<long long const*>(s.value));
+        return pos;
+    case scalar_kind::real:
+        use_value(pos, *static_cast<double const*>(s.value));
+        return pos;
+    case scalar_kind::string:
+        {
+            struct text const t(*static_cast<u8string const*>(s.value));
+            use_value(pos, t, s.copy);
         }
+        return pos;
+    default:
+        return u.bind(*this, pos);
+    }
+}
+//----------------------------------------------------------------------------
+
+void statement::update(into_binder& i)
+{
+    auto const& s = i.scalar_;
+    switch ( s.kind )
+    {
+    case scalar_kind::int32:
+        column_value(s.pos, *static_cast<int*>(s.value));
+        break;
+    case scalar_kind::int64:
+        column_value(s.pos, *static_cast<long long*>(s.value));
+        break;
+    case scalar_kind::real:
+        column_value(s.pos, *static_cast<double*>(s.value));
+        break;
+    case scalar_kind::string:
+        {
+            // reuse string capacity
+            struct text t;
+            column_value(s.pos, t);
+            static_cast<u8string*>(s.value)->assign(t.data ? t.data : "", t.size);
+        }
+        break;
+    case scalar_kind::int32_rows:
+        {
+            int v;
+            column_value(s.pos, v);
+            static_cast<std::vector<int>*>(s.value)->push_back(v);
+        }
+        break;
+    case scalar_kind::int64_rows:
+        {
+            long long v;
+            column_value(s.pos, v);
+            static_cast<std::vector<long long>*>(s.value)->push_back(v);
+        }
+        break;
+    case scalar_kind::real_rows:
+        {
+            double v;
+            column_value(s.pos, v);
+            static_cast<std::vector<double>*>(s.value)->push_back(v);
+        }
+        break;
+    case scalar_kind::text_rows:
+        {
+            struct text t;
+            column_value(s.pos, t);
+            text_column& c = *static_cast<text_column*>(s.value);
+            if ( t.data ) c.push_back(t);
+            else c.push_null();
+        }
+        break;
+    case scalar_kind::blob_rows:
+        {
+            blob_column& c = *static_cast<blob_column*>(s.value);
+            if ( column_type(s.pos) == null )
+            {
+                c.push_null();
+            }
+            else
+            {
+                struct blob b;
+                column_value(s.pos, b);
+                c.push_back(b);
+            }
+        }
+        break;
+    default:
+        i.update(*this);
+        break;
     }
 }
 //----------------------------------------------------------------------------
@@ -144,8 +553,16 @@ void statement::finalize(bool check_error) // throw
 {
     if ( is_prepared() )
     {
-        int const r = sqlite3_finalize(impl_);
+        // return statement to the cache if it belongs to current connection
+        int const r = (sqlite3_db_handle(impl_) == s_.impl())
+            ? s_.cache_.release(impl_, fullscan_base_) : sqlite3_finalize(impl_);
         impl_ = nullptr;
+        columns_ = 0;
+        row_ = false;
+        names_.clear();
+        views_.clear();
+        // bindings are cleared by the cache or finalize
+        owned_.clear();
         if ( check_error )
         {
             s_.check_error(r);
@@ -154,6 +571,27 @@ void statement::finalize(bool check_error) // throw
 }
 //----------------------------------------------------------------------------
 
+void statement::track_view(void const* data) const
+{
+#ifdef NDEBUG
+    (void)data;
+#else
+    if ( data ) views_.push_back(data);
+#endif
+}
+//----------------------------------------------------------------------------
+
+bool statement::is_valid_view(void const* data) const noexcept
+{
+#ifdef NDEBUG
+    (void)data;
+    return true;
+#else
+    return !data || std::find(views_.begin(), views_.end(), data) != views_.end();
+#endif
+}
+//----------------------------------------------------------------------------
+
 bool statement::is_prepared() const noexcept
 {
     return impl_ != nullptr;
@@ -168,9 +606,7 @@ sqlite3_stmt* statement::impl() const noexcept
 
 int statement::column_count() const
 {
-    int count = sqlite3_column_count(impl_);
-    s_.check_last_error();
-    return count;
+    return columns_;
 }
 //----------------------------------------------------------------------------
 
@@ -182,92 +618,194 @@ struct text statement::column_name(int column) const
 }
 //----------------------------------------------------------------------------
 
+namespace {
+
+// FNV-1a of nul-terminated string
+inline std::size_t name_hash(char const* s) noexcept
+{
+    std::size_t h = static_cast<std::size_t>(14695981039346656037ull);
+    for (; *s; ++s)
+    {
+        h = (h ^ static_cast<unsigned char>(*s)) * static_cast<std::size_t>(1099511628211ull);
+    }
+    return h;
+}
+
+} // namespace
+//----------------------------------------------------------------------------
+
 int statement::column_index(struct text const& name) const
 {
-    for (int c = 0, cc = column_count(); c < cc; ++c)
+    if ( columns_ > 0 && name.data )
     {
-        if ( std::strcmp(sqlite3_column_name(impl_, c), name.data) == 0 )
+        if ( names_.empty() )
         {
-            return c;
+            index_names();
+        }
+        std::size_t const mask = names_.size() - 1;
+        std::size_t const hash = name_hash(name.data);
+        for (std::size_t i = hash & mask; names_[i].column >= 0; i = (i + 1) & mask)
+        {
+            if ( names_[i].hash == hash
+                && std::strcmp(sqlite3_column_name(impl_, names_[i].column), name.data) == 0 )
+            {
+                return names_[i].column;
+            }
         }
     }
     throw no_such_column(name);
 }
+//----------------------------------------------------------------------------
+
+void statement::index_names() const
+{
+    // power of two, at most half full
+    std::size_t size = 4;
+    while ( size < 2 * static_cast<std::size_t>(columns_) ) size *= 2;
+
+    name_slot const empty = { 0, -1 };
+    names_.assign(size, empty);
+    for (int c = 0; c < columns_; ++c)
+    {
+        char const* const name = sqlite3_column_name(impl_, c);
+        if ( !name )
+        {
+            // out of memory
+            names_.clear();
+            s_.check_error(SQLITE_NOMEM);
+        }
+        std::size_t const hash = name_hash(name);
+        std::size_t i = hash & (size - 1);
+        for (; names_[i].column >= 0; i = (i + 1) & (size - 1))
+        {
+            // the first one of duplicate names wins
+            if ( names_[i].hash == hash
+                && std::strcmp(sqlite3_column_name(impl_, names_[i].column), name) == 0 ) break;
+        }
+        if ( names_[i].column < 0 )
+        {
+            names_[i].hash = hash;
+            names_[i].column = c;
+        }
+    }
+}
+//----------------------------------------------------------------------------
 
 statement::type statement::column_type(int column) const
 {
-    int const t = sqlite3_column_type(impl_, column);
-    s_.check_last_error();
-    return static_cast<type>(t);
+    check_column(column);
+    return static_cast<type>(sqlite3_column_type(impl_, column));
 }
 //----------------------------------------------------------------------------
 
 void statement::column_value(int column, int& value) const
 {
-    auto v = sqlite3_column_int(impl_, column);
-    s_.check_last_error();
-    value = v;
+    check_column(column);
+    read(column, value);
 }
 //----------------------------------------------------------------------------
 
 void statement::column_value(int column, long long& value) const
 {
-    auto v = sqlite3_column_int64(impl_, column);
-    s_.check_last_error();
-    value = v;
+    check_column(column);
+    read(column, value);
 }
 //----------------------------------------------------------------------------
 
 void statement::column_value(int column, double& value) const
 {
-    auto v = sqlite3_column_double(impl_, column);
-    s_.check_last_error();
-    value = v;
+    check_column(column);
+    read(column, value);
 }
 //----------------------------------------------------------------------------
 
 void statement::column_value(int column, struct blob& value) const
 {
-    // Call sqlite3_column_blob() first to force the result into the desired format,
-    // then invoke sqlite3_column_bytes() to find the size of the result.
-    // https://sqlite.org/c3ref/column_blob.html
-    struct blob b;
-
-    b.data = sqlite3_column_blob(impl_, column);
-    s_.check_last_error();
+    check_column(column);
+    read(column, value);
+}
+//----------------------------------------------------------------------------
 
-    b.size = sqlite3_column_bytes(impl_, column);
-    s_.check_last_error();
+void statement::column_value(int column, struct text& value) const
+{
+    check_column(column);
+    read(column, value);
+}
+//----------------------------------------------------------------------------
 
-    value = b;
+void statement::column_value(int column, struct text16& value) const
+{
+    check_column(column);
+    read(column, value);
 }
 //----------------------------------------------------------------------------
 
-void statement::column_value(int column, struct text& value) const
+void statement::check_column(int column) const
 {
-    struct text t;
+    // the same error as SQLite reports, without error code lookup per cell
+    if ( !row_ || column < 0 || column >= columns_ )
+    {
+        throw exception(SQLITE_RANGE, sqlite3_errstr(SQLITE_RANGE));
+    }
+}
+//----------------------------------------------------------------------------
 
-    t.data = (char const*)sqlite3_column_text(impl_, column);
-    s_.check_last_error();
+void statement::read(int column, int& value) const
+{
+    value = sqlite3_column_int(impl_, column);
+    if ( value == 0 ) check_read();
+}
+//----------------------------------------------------------------------------
 
-    t.size = sqlite3_column_bytes(impl_, column);
-    s_.check_last_error();
+void statement::read(int column, long long& value) const
+{
+    value = sqlite3_column_int64(impl_, column);
+    if ( value == 0 ) check_read();
+}
+//----------------------------------------------------------------------------
 
-    value = t;
+void statement::read(int column, double& value) const
+{
+    value = sqlite3_column_double(impl_, column);
+    if ( value == 0 ) check_read();
 }
 //----------------------------------------------------------------------------
 
-void statement::column_value(int column, struct text16& value) const
+void statement::read(int column, struct blob& value) const
 {
-    struct text16 t;
+    // Call sqlite3_column_blob() first to force the result into the desired format,
+    // then invoke sqlite3_column_bytes() to find the size of the result.
+    // https://sqlite.org/c3ref/column_blob.html
+    value.data = sqlite3_column_blob(impl_, column);
+    value.size = sqlite3_column_bytes(impl_, column);
+    if ( !value.data ) check_read();
+}
+//----------------------------------------------------------------------------
 
-    t.data = (char16_t const*)sqlite3_column_text16(impl_, column);
-    s_.check_last_error();
+void statement::read(int column, struct text& value) const
+{
+    value.data = (char const*)sqlite3_column_text(impl_, column);
+    value.size = sqlite3_column_bytes(impl_, column);
+    if ( !value.data ) check_read();
+}
+//----------------------------------------------------------------------------
 
-    t.size = sqlite3_column_bytes16(impl_, column) / 2;
-    s_.check_last_error();
+void statement::read(int column, struct text16& value) const
+{
+    value.data = (char16_t const*)sqlite3_column_text16(impl_, column);
+    value.size = sqlite3_column_bytes16(impl_, column) / 2;
+    if ( !value.data ) check_read();
+}
+//----------------------------------------------------------------------------
 
-    value = t;
+void statement::check_read() const
+{
+    // sqlite3_step() sets the error code to SQLITE_ROW,
+    // column functions change it only on allocation failure
+    if ( sqlite3_errcode(s_.impl()) == SQLITE_NOMEM )
+    {
+        s_.check_error(SQLITE_NOMEM);
+    }
 }
 //----------------------------------------------------------------------------
 
@@ -338,6 +876,56 @@ void statement::use_value(int pos, struct text16 const& value, bool copy)
     s_.check_error( sqlite3_bind_text16(impl_, pos, value.data,
             (value.size == -1) ? -1 : (int)(value.size * 2), copy ? SQLITE_TRANSIENT : SQLITE_STATIC) );
 }
+//----------------------------------------------------------------------------
+
+void statement::use_value(int pos, u8string&& value)
+{
+    owned_value& slot = own(pos);
+    // moved string keeps its buffer, short ones are stored in the slot itself
+    slot.str = std::move(value);
+    s_.check_error( sqlite3_bind_text64(impl_, pos, slot.str.data(),
+            slot.str.size(), SQLITE_STATIC, SQLITE_UTF8) );
+}
+//----------------------------------------------------------------------------
+
+void statement::use_value(int pos, std::vector<std::uint8_t>&& value)
+{
+    owned_value& slot = own(pos);
+    slot.bytes = std::move(value);
+    // empty vector has no data, bind empty BLOB instead of NULL
+    void const* const data = slot.bytes.empty() ? "" : static_cast<void const*>(slot.bytes.data());
+    s_.check_error( sqlite3_bind_blob64(impl_, pos, data, slot.bytes.size(), SQLITE_STATIC) );
+}
+//----------------------------------------------------------------------------
+
+namespace {
+
+void delete_chars(void* data)
+{
+    delete[] static_cast<char*>(data);
+}
+
+} // namespace
+
+void statement::use_value(int pos, std::unique_ptr<char[]> data, std::size_t size)
+{
+    // SQLite calls the destructor even if bind fails
+    s_.check_error( sqlite3_bind_text64(impl_, pos, data.release(), size, delete_chars, SQLITE_UTF8) );
+}
+//----------------------------------------------------------------------------
+
+statement::owned_value& statement::own(int pos)
+{
+    if ( owned_.empty() )
+    {
+        owned_.resize(sqlite3_bind_parameter_count(impl_));
+    }
+    if ( pos < 1 || pos > static_cast<int>(owned_.size()) )
+    {
+        throw exception(SQLITE_RANGE, sqlite3_errstr(SQLITE_RANGE));
+    }
+    return owned_[pos - 1];
+}
 
 //////////////////////////////////////////////////////////////////////////////
 
@@ -8,11 +8,18 @@
 #ifndef SQLITEPP_STATEMENT_HPP_INCLUDED
 #define SQLITEPP_STATEMENT_HPP_INCLUDED
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+#include <tuple>
 #include <vector>
 
 #include "string.hpp"
 #include "query.hpp"
 #include "converters.hpp"
+#include "metrics.hpp"
 
 struct sqlite3_stmt;
 
@@ -22,9 +29,29 @@ namespace sqlitepp {
 
 //////////////////////////////////////////////////////////////////////////////
 
+namespace detail {
+
+template<std::size_t... I> struct index_list {};
+
+template<std::size_t N, std::size_t... I>
+struct make_index_list : make_index_list<N - 1, N - 1, I...> {};
+
+template<std::size_t... I>
+struct make_index_list<0, I...> { typedef index_list<I...> type; };
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////////
+
+class column_ref;
+class row_range;
+
 // Database statement, noncopyable
 class SQLITEPP_API statement
 {
+    template<typename Signature> friend class typed_statement; // access to read and track
+    friend class column_ref; // access to generation_
+
 public:
     // Create an empty statement
     explicit statement(session& s) noexcept;
@@ -42,10 +69,15 @@ public:
     // Execute statement. Return true if result exists.
     bool exec();
 
+    // Execute statement for up to n rows, so that into_rows() bindings
+    // append n values at most. Return number of rows fetched, less than n
+    // at the end of result. Like exec(), fetch after the end restarts.
+    std::size_t fetch(std::size_t n);
+
     // Prepare statement.
     void prepare();
 
-    // Finalize statement.
+    // Finalize statement. Prepared statement is returned to session cache.
     void finalize(bool check_error = true);
 
     // Is statement prepared.
@@ -57,6 +89,26 @@ public:
     // Reset statement. Return to prepared state. Optionally rebind values
     void reset(bool rebind = false);
 
+    // Counters of prepared statement, optionally reset them.
+    statement_metrics metrics(bool reset = false) const;
+
+    // Loops of prepared statement with rows visited since prepare or reset,
+    // optionally reset them. Empty unless SQLite is built with
+    // SQLITE_ENABLE_STMT_SCANSTATUS, see has_scan_status().
+    std::vector<scan_loop> scan_status(bool reset = false) const;
+
+    // Is scan_status() available?
+    static bool has_scan_status() noexcept;
+
+    // Throw deadline_exceeded when statement steps past deadline, or when
+    // its run takes longer than timeout, zero timeout disables it.
+    // Checked as the session deadline, see session::set_deadline().
+    void set_deadline(std::chrono::steady_clock::time_point deadline);
+    void set_timeout(std::chrono::nanoseconds timeout);
+
+    // Remove statement deadline and timeout.
+    void clear_deadline() noexcept;
+
     // Start statement preparing.
     template<typename T>
     prepare_query operator<<(T const& t)
@@ -76,8 +128,12 @@ public:
     int column_count() const;
     // Column name in result set.
     struct text column_name(int column) const;
-    // Column index in result set.
+    // Column index in result set, by hash table built once per prepare.
     int column_index(struct text const& name) const;
+    // Column handle by name, resolves its index once per prepare.
+    column_ref column(struct text const& name);
+    // Input range of result rows, each step executes statement.
+    row_range rows() noexcept;
     // Column type of result set in prepared statement.
     enum type { integer = 1, real = 2, text = 3, blob = 4, null = 5 };
     // Column type in result set.
@@ -102,9 +158,15 @@ public:
     {
         typename converter<T>::base_type t;
         column_value(column, t);
+        if ( is_column_view<T>::value ) track(t);
         return converter<T>::to(t);
     }
 
+    // Was data of a view returned by get() or typed_statement for the
+    // current row, so it is still valid? Views are tracked when the library
+    // is built without NDEBUG, otherwise always true.
+    bool is_valid_view(void const* data) const noexcept;
+
     // Get use position by name in query.
     int use_pos(struct text const& name) const;
     // Get use parameter count in query.
@@ -125,12 +187,243 @@ public:
     // Use UTF-16 string value in query.
     void use_value(int pos, struct text16 const& value, bool copy = false);
 
+    // Use UTF-8 string value in query, moved into statement without copy.
+    // Statement owns the value until the parameter is bound again or finalized.
+    void use_value(int pos, u8string&& value);
+    // Use BLOB value in query, moved into statement without copy.
+    void use_value(int pos, std::vector<std::uint8_t>&& value);
+    // Use UTF-8 string of size bytes in query, SQLite takes ownership of data.
+    void use_value(int pos, std::unique_ptr<char[]> data, std::size_t size);
+
 private:
+    // Column values of a valid column in current row.
+    // Errors are looked up only for results which may signal out of memory.
+    void read(int column, int& value) const;
+    void read(int column, long long& value) const;
+    void read(int column, double& value) const;
+    void read(int column, struct blob& value) const;
+    void read(int column, struct text& value) const;
+    void read(int column, struct text16& value) const;
+    // Throw if last column read failed to allocate memory.
+    void check_read() const;
+
+    // Bind use binder, scalars directly. Returns last bound position.
+    int bind(use_binder& u, int pos);
+    // Update into binder, scalars directly.
+    void update(into_binder& i);
+
+    // Call full scan handler of session if the statement scanned too much.
+    void check_fullscan();
+
+    // Throw if there is no current row or column is out of range.
+    void check_column(int column) const;
+    // Build column name hash table.
+    void index_names() const;
+
+    // Values moved into statement, one slot per parameter.
+    struct owned_value
+    {
+        u8string str;
+        std::vector<std::uint8_t> bytes;
+    };
+    // Slot of parameter pos, slots are allocated once per prepare
+    // and never move while bound.
+    owned_value& own(int pos);
+
+    // Remember view data returned for the current row.
+    template<typename B>
+    void track(B const&) const {}
+    void track(struct blob const& b) const { track_view(b.data); }
+    void track(struct text const& t) const { track_view(t.data); }
+    void track(struct text16 const& t) const { track_view(t.data); }
+    // Out of line, so that headers do not depend on NDEBUG.
+    void track_view(void const* data) const;
+
     session& s_;
     query q_;
     sqlite3_stmt* impl_;
+    // Column count, cached on prepare and updated on each row.
+    int columns_;
+    // Is there a current row to read columns from?
+    bool row_;
+    // Open addressing hash table of column names, empty until first lookup.
+    struct name_slot { std::size_t hash; int column; };
+    mutable std::vector<name_slot> names_;
+    // Incremented on each prepare and reprepare.
+    unsigned generation_;
+    // Reprepare count of statement when columns were read.
+    mutable int reprepares_;
+    // Full scan steps of statement when the full scan guard flagged it last.
+    mutable int fullscan_base_;
+    // Data of views returned since the last step or reset, debug builds only.
+    mutable std::vector<void const*> views_;
+    // Parameter values owned by statement, empty until first moved in.
+    std::vector<owned_value> owned_;
+    // Deadline and timeout, and deadline of the current run.
+    std::chrono::steady_clock::time_point deadline_;
+    std::chrono::nanoseconds timeout_;
+    std::chrono::steady_clock::time_point run_deadline_;
 };
 
+// Result column by name. The index is looked up on first use
+// and reused across rows and resets until the statement is prepared again.
+class SQLITEPP_API column_ref
+{
+public:
+    column_ref(statement& st, struct text const& name)
+        : st_(&st)
+        , name_(name.to_string())
+        , index_(-1)
+        , generation_(0)
+    {
+    }
+
+    // Column index in result set.
+    int index() const
+    {
+        if ( generation_ != st_->generation_ )
+        {
+            index_ = st_->column_index(name_);
+            generation_ = st_->generation_;
+        }
+        return index_;
+    }
+
+    // Column name.
+    u8string const& name() const noexcept { return name_; }
+
+    // Column type in current row.
+    statement::type type() const { return st_->column_type(index()); }
+
+    // Column value in current row as type T.
+    template<typename T>
+    T get() const { return st_->get<T>(index()); }
+
+private:
+    statement* st_;
+    u8string name_;
+    mutable int index_;
+    mutable unsigned generation_;
+};
+
+inline column_ref statement::column(struct text const& name)
+{
+    return column_ref(*this, name);
+}
+
+// Current result row of a statement. Views of text and blob columns
+// point into SQLite buffers, valid until the next step or reset.
+class row
+{
+public:
+    row() noexcept : st_(nullptr) {}
+    explicit row(statement& st) noexcept : st_(&st) {}
+
+    // Number of columns.
+    int size() const { return st_->column_count(); }
+
+    // Column type.
+    statement::type type(int column) const { return st_->column_type(column); }
+
+    // Is column NULL?
+    bool is_null(int column) const { return type(column) == statement::null; }
+
+    // Column value as type T, text and blob without copy.
+    template<typename T>
+    T get(int column) const { return st_->get<T>(column); }
+
+    // Column value by name as type T.
+    template<typename T>
+    T get(struct text const& name) const { return st_->get<T>(st_->column_index(name)); }
+
+    // First columns as tuple of types T..., e.g. for structured bindings:
+    //     auto [id, name] = r.as<int, text>();
+    template<typename... T>
+    std::tuple<T...> as() const
+    {
+        return as<T...>(typename detail::make_index_list<sizeof...(T)>::type());
+    }
+
+    // Owning statement.
+    statement& st() const noexcept { return *st_; }
+
+private:
+    template<typename... T, std::size_t... I>
+    std::tuple<T...> as(detail::index_list<I...>) const
+    {
+        return std::tuple<T...>(get<T>(static_cast<int>(I))...);
+    }
+
+    statement* st_;
+};
+
+// Input iterator over result rows, end iterator has no statement.
+class row_iterator
+{
+public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef row value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef row const* pointer;
+    typedef row const& reference;
+
+    row_iterator() noexcept : end_(true) {}
+
+    // Step to the first row.
+    explicit row_iterator(statement& st) : row_(st), end_(!st.exec()) {}
+
+    reference operator*() const noexcept { return row_; }
+    pointer operator->() const noexcept { return &row_; }
+
+    row_iterator& operator++()
+    {
+        end_ = !row_.st().exec();
+        return *this;
+    }
+
+    row_iterator operator++(int)
+    {
+        row_iterator const prev(*this);
+        ++*this;
+        return prev;
+    }
+
+    // Iterators are equal when both are at the end.
+    friend bool operator==(row_iterator const& lhs, row_iterator const& rhs) noexcept
+    {
+        return lhs.end_ == rhs.end_;
+    }
+
+    friend bool operator!=(row_iterator const& lhs, row_iterator const& rhs) noexcept
+    {
+        return lhs.end_ != rhs.end_;
+    }
+
+private:
+    row row_;
+    bool end_;
+};
+
+// Rows of statement result for range-for and standard algorithms:
+//     for (row const& r : st.rows()) sum += r.get<int>(0);
+// begin() executes statement, iteration is single pass.
+class row_range
+{
+public:
+    explicit row_range(statement& st) noexcept : st_(&st) {}
+
+    row_iterator begin() const { return row_iterator(*st_); }
+    row_iterator end() const noexcept { return row_iterator(); }
+
+private:
+    statement* st_;
+};
+
+inline row_range statement::rows() noexcept
+{
+    return row_range(*this);
+}
+
 //////////////////////////////////////////////////////////////////////////////
 
 } // namespace sqlitepp
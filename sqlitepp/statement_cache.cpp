@@ -0,0 +1,193 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <cstring>
+
+#include <sqlite3.h>
+
+#include "statement_cache.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+statement_cache::statement_cache(std::size_t capacity) noexcept
+    : capacity_(capacity)
+    , hits_(0)
+    , misses_(0)
+    , evictions_(0)
+{
+}
+//----------------------------------------------------------------------------
+
+statement_cache::~statement_cache()
+{
+    clear();
+}
+//----------------------------------------------------------------------------
+
+std::size_t statement_cache::capacity() const noexcept
+{
+    return capacity_;
+}
+//----------------------------------------------------------------------------
+
+void statement_cache::capacity(std::size_t capacity)
+{
+    capacity_ = capacity;
+    evict(capacity_);
+}
+//----------------------------------------------------------------------------
+
+std::size_t statement_cache::size() const noexcept
+{
+    return lru_.size();
+}
+//----------------------------------------------------------------------------
+
+unsigned long long statement_cache::hits() const noexcept
+{
+    return hits_;
+}
+//----------------------------------------------------------------------------
+
+unsigned long long statement_cache::misses() const noexcept
+{
+    return misses_;
+}
+//----------------------------------------------------------------------------
+
+unsigned long long statement_cache::evictions() const noexcept
+{
+    return evictions_;
+}
+//----------------------------------------------------------------------------
+
+void statement_cache::clear() noexcept
+{
+    for (auto& e : lru_) sqlite3_finalize(e.st);
+    lru_.clear();
+    index_.clear();
+}
+//----------------------------------------------------------------------------
+
+bool statement_cache::key::operator==(key const& other) const noexcept
+{
+    return size == other.size && std::memcmp(data, other.data, size) == 0;
+}
+//----------------------------------------------------------------------------
+
+std::size_t statement_cache::key_hash::operator()(key const& k) const noexcept
+{
+    // FNV-1a
+    std::size_t h = static_cast<std::size_t>(14695981039346656037ull);
+    for (std::size_t i = 0; i < k.size; ++i)
+    {
+        h = (h ^ static_cast<unsigned char>(k.data[i])) * static_cast<std::size_t>(1099511628211ull);
+    }
+    return h;
+}
+//----------------------------------------------------------------------------
+
+sqlite3_stmt* statement_cache::acquire(text const& sql, int& fullscan_base)
+{
+    if ( capacity_ == 0 )
+    {
+        return nullptr;
+    }
+
+    key const k = { sql.data, sql.size != std::size_t(-1) ? sql.size : std::strlen(sql.data) };
+    auto const found = index_.find(k);
+    if ( found == index_.end() )
+    {
+        ++misses_;
+        return nullptr;
+    }
+
+    ++hits_;
+    auto const e = found->second;
+    sqlite3_stmt* const st = e->st;
+    fullscan_base = e->fullscan_base;
+    index_.erase(found); // before its key storage is erased
+    lru_.erase(e);
+    return st;
+}
+//----------------------------------------------------------------------------
+
+int statement_cache::release(sqlite3_stmt* st, int fullscan_base) noexcept
+{
+    if ( capacity_ == 0 )
+    {
+        return sqlite3_finalize(st);
+    }
+
+    // sqlite3_sql() returns the text passed to sqlite3_prepare_v2(),
+    // which is the key statement was acquired with.
+    char const* const sql = sqlite3_sql(st);
+    if ( !sql )
+    {
+        return sqlite3_finalize(st);
+    }
+
+    int const r = sqlite3_reset(st);
+    sqlite3_clear_bindings(st);
+
+    // another statement with the same SQL was checked in already
+    key const k = { sql, std::strlen(sql) };
+    if ( index_.count(k) )
+    {
+        sqlite3_finalize(st);
+        return r;
+    }
+
+    try
+    {
+        entry const e = { sql, st, fullscan_base };
+        lru_.push_front(e);
+        try
+        {
+            u8string const& s = lru_.front().sql;
+            key const stored = { s.data(), s.size() };
+            index_.emplace(stored, lru_.begin());
+        }
+        catch (...)
+        {
+            lru_.pop_front();
+            throw;
+        }
+    }
+    catch (...)
+    {
+        sqlite3_finalize(st);
+        return r;
+    }
+    evict(capacity_);
+    return r;
+}
+//----------------------------------------------------------------------------
+
+void statement_cache::evict(std::size_t capacity) noexcept
+{
+    while ( lru_.size() > capacity )
+    {
+        auto& e = lru_.back();
+        sqlite3_finalize(e.st);
+        key const k = { e.sql.data(), e.sql.size() };
+        index_.erase(k);
+        lru_.pop_back();
+        ++evictions_;
+    }
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,112 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_STATEMENT_CACHE_HPP_INCLUDED
+#define SQLITEPP_STATEMENT_CACHE_HPP_INCLUDED
+
+#include <list>
+#include <unordered_map>
+
+#include "string.hpp"
+
+struct sqlite3_stmt;
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// LRU cache of prepared statements keyed by SQL text. Noncopyable.
+// A cached statement is checked out by statement::prepare() and
+// returned in reset state with cleared bindings by statement::finalize().
+class SQLITEPP_API statement_cache
+{
+    friend class session;   // access to clear on close
+    friend class statement; // access to acquire and release
+
+public:
+    // Create a cache with capacity.
+    explicit statement_cache(std::size_t capacity = 16) noexcept;
+
+    statement_cache(statement_cache const&) = delete;
+    statement_cache& operator=(statement_cache const&) = delete;
+
+    // Finalize all cached statements on destroy.
+    ~statement_cache();
+
+    // Maximum number of cached statements, 0 disables caching.
+    std::size_t capacity() const noexcept;
+
+    // Set maximum number of cached statements, evict exceeding ones.
+    void capacity(std::size_t capacity);
+
+    // Number of currently cached statements.
+    std::size_t size() const noexcept;
+
+    // Number of prepares served from the cache.
+    unsigned long long hits() const noexcept;
+
+    // Number of prepares not found in the cache.
+    unsigned long long misses() const noexcept;
+
+    // Number of statements finalized because the cache was full.
+    unsigned long long evictions() const noexcept;
+
+    // Finalize all cached statements.
+    void clear() noexcept;
+
+private:
+    // Check out statement prepared for sql, null if there is no one.
+    // Full scan steps of its last full scan guard flag are put into fullscan_base.
+    sqlite3_stmt* acquire(text const& sql, int& fullscan_base);
+
+    // Reset statement and put it into the cache with fullscan_base,
+    // or finalize it. Return sqlite3_reset or sqlite3_finalize result.
+    int release(sqlite3_stmt* st, int fullscan_base) noexcept;
+
+    void evict(std::size_t capacity) noexcept;
+
+    struct entry
+    {
+        u8string sql;
+        sqlite3_stmt* st;
+        int fullscan_base;
+    };
+    typedef std::list<entry> lru_list;
+
+    // SQL text view, refers to a string in lru_ or to the looked up text,
+    // so lookup does not allocate.
+    struct key
+    {
+        char const* data;
+        std::size_t size;
+        bool operator==(key const& other) const noexcept;
+    };
+
+    struct key_hash
+    {
+        std::size_t operator()(key const& k) const noexcept;
+    };
+
+    lru_list lru_; // most recently used first
+    std::unordered_map<key, lru_list::iterator, key_hash> index_;
+    std::size_t capacity_;
+    unsigned long long hits_;
+    unsigned long long misses_;
+    unsigned long long evictions_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_STATEMENT_CACHE_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
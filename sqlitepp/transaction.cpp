@@ -19,31 +19,32 @@ namespace sqlitepp {
 
 transaction::transaction(session& s, type t)
     : s_(&s)
+    , parent_(s.active_txn())
 {
-    if ( s_->active_txn() )
+    if ( parent_ )
     {
-        throw nested_txn_not_supported();
+        s_->exec_control(session::savepoint_txn);
+        s_->active_txn_ = this;
+        return;
     }
 
-    char const* begin_cmd;
     switch ( t )
     {
     case deferred:
-        begin_cmd = "begin deferred";
+        s_->exec_control(session::begin_deferred);
         break;
     case immediate:
-        begin_cmd = "begin immediate";
+        s_->exec_control(session::begin_immediate);
         break;
     case exclusive:
-        begin_cmd = "begin exclusive";
+        s_->exec_control(session::begin_exclusive);
         break;
     default:
         assert(!"unknown transaction type");
-        begin_cmd = "begin";
+        s_->exec_control(session::begin_deferred);
         break;
     }
 
-    *s_ << begin_cmd;
     s_->active_txn_ = this;
 }
 //----------------------------------------------------------------------------
@@ -65,9 +66,18 @@ void transaction::rollback()
 {
     if ( s_ )
     {
-        *s_ << "rollback";
-        s_->active_txn_ = nullptr;
-        s_ = nullptr;
+        if ( parent_ )
+        {
+            release_nested();
+            // rollback to savepoint keeps it on the stack, release it then
+            s_->exec_control(session::rollback_to_txn);
+            s_->exec_control(session::release_txn);
+        }
+        else
+        {
+            s_->exec_control(session::rollback_txn);
+        }
+        end();
     }
 }
 //----------------------------------------------------------------------------
@@ -76,13 +86,57 @@ void transaction::commit()
 {
     if ( s_ )
     {
-        *s_ << "commit";
-        s_->active_txn_ = nullptr;
-        s_ = nullptr;
+        if ( parent_ )
+        {
+            release_nested();
+            s_->exec_control(session::release_txn);
+        }
+        else
+        {
+            s_->exec_control(session::commit_txn);
+        }
+        end();
     }
 }
 //----------------------------------------------------------------------------
 
+bool transaction::is_nested() const noexcept
+{
+    return parent_ != nullptr;
+}
+//----------------------------------------------------------------------------
+
+transaction* transaction::parent() const noexcept
+{
+    return parent_;
+}
+//----------------------------------------------------------------------------
+
+void transaction::release_nested()
+{
+    // savepoints share one name, release the nested ones innermost first
+    // so the name refers to the savepoint of this transaction
+    for (transaction* t = s_->active_txn_; t != this; t = t->parent_)
+    {
+        assert(t && "transaction is not active in session");
+        s_->exec_control(session::release_txn);
+    }
+}
+//----------------------------------------------------------------------------
+
+void transaction::end() noexcept
+{
+    // savepoints of nested transactions are gone with this one
+    for (transaction* t = s_->active_txn_; t != this; t = t->parent_)
+    {
+        assert(t && "transaction is not active in session");
+        t->s_ = nullptr;
+    }
+    s_->active_txn_ = parent_;
+    s_ = nullptr;
+}
+//----------------------------------------------------------------------------
+
 //////////////////////////////////////////////////////////////////////////////
 
 } // namespace sqlitepp
@@ -17,10 +17,13 @@ namespace sqlitepp {
 //////////////////////////////////////////////////////////////////////////////
 
 // Transaction. Noncopyable.
+// Transaction started while another one is active in the session is nested:
+// it is implemented with SAVEPOINT, RELEASE and ROLLBACK TO,
+// so only the outermost transaction commits to the database.
 class SQLITEPP_API transaction
 {
 public:
-    // Transaction type
+    // Transaction type, ignored for nested transactions.
     enum type { deferred, immediate, exclusive };
 
     // Begin transaction in context of session.
@@ -32,14 +35,26 @@ public:
     // End transaction with rollback if it is not committed.
     ~transaction();
 
-    // Rollback transaction
+    // Rollback transaction, and all transactions nested in it.
     void rollback();
 
-    // Commit transaction.
+    // Commit transaction, and all transactions nested in it.
     void commit();
 
+    // Is transaction nested in another one?
+    bool is_nested() const noexcept;
+
+    // Transaction this one is nested in, null for the outermost.
+    transaction* parent() const noexcept;
+
 private:
+    // Release savepoints of transactions nested in this one.
+    void release_nested();
+    // End this and nested transactions in session.
+    void end() noexcept;
+
     session* s_;
+    transaction* parent_;
 };
 
 //////////////////////////////////////////////////////////////////////////////
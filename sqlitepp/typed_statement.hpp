@@ -0,0 +1,182 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_TYPED_STATEMENT_HPP_INCLUDED
+#define SQLITEPP_TYPED_STATEMENT_HPP_INCLUDED
+
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "statement.hpp"
+#include "converters.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace detail {
+
+// Does any of T point into a column value?
+template<typename... T>
+struct has_column_view : std::false_type {};
+
+template<typename T, typename... Rest>
+struct has_column_view<T, Rest...>
+    : std::integral_constant<bool, is_column_view<T>::value || has_column_view<Rest...>::value> {};
+
+} // namespace detail
+
+//////////////////////////////////////////////////////////////////////////////
+
+template<typename Signature>
+class typed_statement;
+
+// Statement with parameter and result column types known at compile time.
+// Noncopyable. Signature is std::tuple<Columns...>(Params...), values are
+// converted with converter<T>, without binders and virtual calls:
+//
+//     typed_statement<std::tuple<int, u8string>(int)> ts(s, "select id, name from t where id > ?");
+//     for (auto const& row : ts.query(42)) ...
+//
+template<typename... Columns, typename... Params>
+class typed_statement<std::tuple<Columns...>(Params...)>
+{
+public:
+    typedef std::tuple<Columns...> row_type;
+
+    // Prepare statement, check its column and parameter count.
+    typed_statement(session& s, text const& sql)
+        : st_(s, sql)
+        , borrowed_(false)
+    {
+        st_.prepare();
+        if ( st_.column_count() != static_cast<int>(sizeof...(Columns)) )
+        {
+            throw std::invalid_argument("typed_statement column count mismatch");
+        }
+        if ( st_.use_count() != static_cast<int>(sizeof...(Params)) )
+        {
+            throw std::invalid_argument("typed_statement parameter count mismatch");
+        }
+    }
+
+    // Reset statement and bind parameters. Values are copied by SQLite.
+    void bind(Params const&... params)
+    {
+        bind_values(true, params...);
+    }
+
+    // Step to the next row and read it. Return false at the end of result.
+    // Existing row values are overwritten, strings keep their capacity.
+    bool fetch(row_type& row)
+    {
+        if ( borrowed_ )
+        {
+            throw std::logic_error("typed_statement parameters are not bound after query or exec");
+        }
+        return next(row);
+    }
+
+    // Bind parameters and read all rows. Values are not copied, they are
+    // bound for this call only.
+    std::vector<row_type> query(Params const&... params)
+    {
+        static_assert(!detail::has_column_view<Columns...>::value,
+            "view columns are invalid after the next row, read them with fetch()");
+        bind_values(false, params...);
+        std::vector<row_type> rows;
+        row_type row;
+        while ( next(row) )
+        {
+            // overwritten by the next row
+            rows.push_back(std::move(row));
+        }
+        return rows;
+    }
+
+    // Bind parameters and execute statement until done, result rows are skipped.
+    // Values are not copied, they are bound for this call only.
+    void exec(Params const&... params)
+    {
+        bind_values(false, params...);
+        while ( st_.exec() ) {}
+    }
+
+    // Underlying statement.
+    statement& st() noexcept { return st_; }
+
+private:
+    // Reset statement and bind parameters, copied or living until the statement is done.
+    void bind_values(bool copy, Params const&... params)
+    {
+        st_.reset();
+        borrowed_ = !copy;
+        bind_params(copy, typename detail::make_index_list<sizeof...(Params)>::type(), params...);
+    }
+
+    template<std::size_t... I>
+    void bind_params(bool copy, detail::index_list<I...>, Params const&... params)
+    {
+        int expand[] = { 0, (st_.use_value(static_cast<int>(I) + 1,
+            converter<typename std::decay<Params>::type>::from(params), copy), 0)... };
+        (void)expand;
+        (void)copy;
+    }
+
+    bool next(row_type& row)
+    {
+        if ( !st_.exec() )
+        {
+            return false;
+        }
+        read_row(row, typename detail::make_index_list<sizeof...(Columns)>::type());
+        return true;
+    }
+
+    template<std::size_t... I>
+    void read_row(row_type& row, detail::index_list<I...>)
+    {
+        int expand[] = { 0, (read_column(static_cast<int>(I), std::get<I>(row)), 0)... };
+        (void)expand;
+    }
+
+    template<typename T>
+    void read_column(int column, T& value)
+    {
+        typename converter<T>::base_type t;
+        st_.read(column, t);
+        if ( is_column_view<T>::value ) st_.track(t);
+        value = converter<T>::to(t);
+    }
+
+    void read_column(int column, u8string& value)
+    {
+        text t;
+        st_.read(column, t);
+        value.assign(t.data ? t.data : "", t.size);
+    }
+
+    statement st_;
+    // Parameters were bound without copy by query() or exec().
+    bool borrowed_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_TYPED_STATEMENT_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
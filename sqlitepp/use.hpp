@@ -25,7 +25,22 @@ class use_nameless_binder : public use_binder
 {
 public:
     explicit use_nameless_binder(T&& value, bool copy)
-        : value_(std::forward<T>(value)), copy_(copy) {}
+        : value_(std::forward<T>(value)), copy_(copy)
+    {
+        this->scalar(kind, &this->value_, -1, copy_);
+    }
+
+    use_nameless_binder(use_nameless_binder&& src)
+        : use_binder(std::move(src)), value_(std::forward<T>(src.value_)), copy_(src.copy_)
+    {
+        // value_ could be stored in this binder
+        this->scalar(kind, &this->value_, -1, copy_);
+    }
+
+    operator use_binder_ptr() &&
+    {
+        return use_binder_ptr(new use_nameless_binder(std::move(*this)));
+    }
 
     int bind(statement& st, int pos) override
     {
@@ -34,6 +49,8 @@ public:
     }
 
 protected:
+    static constexpr scalar_kind kind = scalar_kind_of<typename std::decay<T>::type>::value;
+
     T value_;
     bool copy_;
 };
@@ -45,7 +62,21 @@ class use_pos_binder : public use_nameless_binder<T>
 public:
     use_pos_binder(T&& value, int pos, bool copy)
         : use_nameless_binder<T>(std::forward<T>(value), copy)
-        , pos_(pos) {}
+        , pos_(pos)
+    {
+        this->scalar(this->kind, &this->value_, pos_, this->copy_);
+    }
+
+    use_pos_binder(use_pos_binder&& src)
+        : use_nameless_binder<T>(std::move(src)), pos_(src.pos_)
+    {
+        this->scalar(this->kind, &this->value_, pos_, this->copy_);
+    }
+
+    operator use_binder_ptr() &&
+    {
+        return use_binder_ptr(new use_pos_binder(std::move(*this)));
+    }
 
     int bind(statement& st, int) override
     {
@@ -63,11 +94,30 @@ class use_name_binder : public use_pos_binder<T>
 public:
     use_name_binder(T&& value, text const& name, bool copy)
         : use_pos_binder<T>(std::forward<T>(value), -1, copy)
-        , name_(name.to_string()) {}
+        , name_(name.to_string())
+    {
+        // bind virtually until position is resolved
+        this->scalar(scalar_kind::none, nullptr, -1, false);
+    }
+
+    use_name_binder(use_name_binder&& src)
+        : use_pos_binder<T>(std::move(src)), name_(src.name_)
+    {
+        if (this->pos_ < 0) this->scalar(scalar_kind::none, nullptr, -1, false);
+    }
+
+    operator use_binder_ptr() &&
+    {
+        return use_binder_ptr(new use_name_binder(std::move(*this)));
+    }
 
     int bind(statement& st, int) override
     {
-        if (this->pos_ < 0) this->pos_ = st.use_pos(this->name_);
+        if (this->pos_ < 0)
+        {
+            this->pos_ = st.use_pos(this->name_);
+            this->scalar(this->kind, &this->value_, this->pos_, this->copy_);
+        }
         return use_pos_binder<T>::bind(st, this->pos_);
     }
 
@@ -76,26 +126,28 @@ protected:
 };
 
 // Create anonymous parameter use binding for reference t.
+// Binder is stored in query without heap allocation,
+// it converts to use_binder_ptr if needed.
 template<typename T>
-inline use_binder_ptr use(T&& t, bool copy = false)
+inline use_nameless_binder<T> use(T&& t, bool copy = false)
 {
-    return use_binder_ptr(new use_nameless_binder<T>(std::forward<T>(t), copy));
+    return use_nameless_binder<T>(std::forward<T>(t), copy);
 }
 //----------------------------------------------------------------------------
 
 // Create positional use binding for reference t.
 template<typename T>
-inline use_binder_ptr use(T&& t, int pos, bool copy = false)
+inline use_pos_binder<T> use(T&& t, int pos, bool copy = false)
 {
-    return use_binder_ptr(new use_pos_binder<T>(std::forward<T>(t), pos, copy));
+    return use_pos_binder<T>(std::forward<T>(t), pos, copy);
 }
 //----------------------------------------------------------------------------
 
 // Create named use binding for reference t.
 template<typename T>
-inline use_binder_ptr use(T&& t, text const& name, bool copy = false)
+inline use_name_binder<T> use(T&& t, text const& name, bool copy = false)
 {
-    return use_binder_ptr(new use_name_binder<T>(std::forward<T>(t), name, copy));
+    return use_name_binder<T>(std::forward<T>(t), name, copy);
 }
 //----------------------------------------------------------------------------
 
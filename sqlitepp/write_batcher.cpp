@@ -0,0 +1,245 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#include <stdexcept>
+#include <vector>
+
+#include "write_batcher.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+write_batcher::write_batcher(text const& filename, options const& opts, unsigned flags)
+    : db_(filename, flags)
+    , opts_(opts)
+    , tail_(&stub_)
+    , head_(&stub_)
+    , stopped_(false)
+    , sleeping_(false)
+    , pushers_(0)
+    , batches_(0)
+    , writes_(0)
+{
+    worker_ = std::thread(&write_batcher::run, this);
+}
+//----------------------------------------------------------------------------
+
+write_batcher::~write_batcher()
+{
+    stop();
+}
+//----------------------------------------------------------------------------
+
+void write_batcher::stop()
+{
+    stopped_ = true;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeup_.notify_one();
+    }
+    if ( worker_.joinable() )
+    {
+        worker_.join();
+    }
+
+    // producers which passed the stopped check link their nodes soon
+    while ( pushers_ != 0 )
+    {
+        std::this_thread::yield();
+    }
+
+    // writes queued concurrently with stop
+    while ( node* n = pop() )
+    {
+        std::unique_ptr<node> _(n);
+        n->fail(std::make_exception_ptr(std::logic_error("write_batcher is stopped")));
+    }
+}
+//----------------------------------------------------------------------------
+
+unsigned long long write_batcher::batches() const noexcept
+{
+    return batches_;
+}
+//----------------------------------------------------------------------------
+
+unsigned long long write_batcher::writes() const noexcept
+{
+    return writes_;
+}
+//----------------------------------------------------------------------------
+
+void write_batcher::push(std::unique_ptr<node> n)
+{
+    // pairs with stop: either we see it stopped, or it waits for our link
+    ++pushers_;
+    if ( stopped_ )
+    {
+        --pushers_;
+        throw std::logic_error("write_batcher is stopped");
+    }
+
+    link(n.release());
+    --pushers_;
+
+    // pairs with the fence in pop_wait: either the worker sees the new node,
+    // or we see it sleeping and wake it up
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if ( sleeping_.load(std::memory_order_relaxed) )
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        wakeup_.notify_one();
+    }
+}
+//----------------------------------------------------------------------------
+
+void write_batcher::link(node* n) noexcept
+{
+    n->next.store(nullptr, std::memory_order_relaxed);
+    node* const prev = tail_.exchange(n, std::memory_order_acq_rel);
+    prev->next.store(n, std::memory_order_release);
+}
+//----------------------------------------------------------------------------
+
+write_batcher::node* write_batcher::pop() noexcept
+{
+    node* head = head_;
+    node* next = head->next.load(std::memory_order_acquire);
+    if ( head == &stub_ )
+    {
+        if ( !next )
+        {
+            return nullptr;
+        }
+        head_ = head = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+    if ( next )
+    {
+        head_ = next;
+        return head;
+    }
+    if ( head != tail_.load(std::memory_order_acquire) )
+    {
+        // a producer has not linked its node yet
+        return nullptr;
+    }
+    // head is the last node, put stub behind it to detach head
+    link(&stub_);
+    next = head->next.load(std::memory_order_acquire);
+    if ( next )
+    {
+        head_ = next;
+        return head;
+    }
+    return nullptr;
+}
+//----------------------------------------------------------------------------
+
+write_batcher::node* write_batcher::pop_wait(std::chrono::steady_clock::time_point until)
+{
+    node* n = pop();
+    if ( n )
+    {
+        return n;
+    }
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    sleeping_.store(true, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    while ( !(n = pop()) && !stopped_ )
+    {
+        if ( until == std::chrono::steady_clock::time_point::max() )
+        {
+            wakeup_.wait(lock);
+        }
+        else if ( wakeup_.wait_until(lock, until) == std::cv_status::timeout )
+        {
+            n = pop();
+            break;
+        }
+    }
+    sleeping_.store(false, std::memory_order_relaxed);
+    return n;
+}
+//----------------------------------------------------------------------------
+
+void write_batcher::run()
+{
+    for (;;)
+    {
+        if ( node* n = pop_wait(std::chrono::steady_clock::time_point::max()) )
+        {
+            run_batch(n);
+        }
+        else if ( stopped_ )
+        {
+            break;
+        }
+    }
+}
+//----------------------------------------------------------------------------
+
+void write_batcher::run_batch(node* first)
+{
+    auto const deadline = std::chrono::steady_clock::now() + opts_.max_delay;
+    std::vector<std::unique_ptr<node>> succeeded;
+    std::unique_ptr<node> n(first);
+    try
+    {
+        transaction txn(db_, opts_.txn_type);
+        for (std::size_t count = 0; n; )
+        {
+            try
+            {
+                // nested transaction rolls back failed write alone
+                transaction sp(db_);
+                n->run(db_);
+                sp.commit();
+                succeeded.push_back(std::move(n));
+            }
+            catch (...)
+            {
+                n->fail(std::current_exception());
+                n.reset();
+            }
+            ++writes_;
+
+            if ( ++count >= opts_.max_batch )
+            {
+                break;
+            }
+            n.reset(pop());
+            if ( !n && opts_.max_delay.count() > 0 && std::chrono::steady_clock::now() < deadline )
+            {
+                n.reset(pop_wait(deadline));
+            }
+        }
+        txn.commit();
+    }
+    catch (...)
+    {
+        // begin or commit failed, the whole batch is rolled back
+        std::exception_ptr const e = std::current_exception();
+        if ( n ) n->fail(e);
+        for (auto& s : succeeded) s->fail(e);
+        return;
+    }
+
+    ++batches_;
+    for (auto& s : succeeded) s->done();
+}
+//----------------------------------------------------------------------------
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,171 @@
+//////////////////////////////////////////////////////////////////////////////
+//
+// Copyright (c) 2019 huangqinjin
+// Use, modification and distribution is subject to the
+// Boost Software License, Version 1.0. (See accompanying file
+// LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+#ifndef SQLITEPP_WRITE_BATCHER_HPP_INCLUDED
+#define SQLITEPP_WRITE_BATCHER_HPP_INCLUDED
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include "session.hpp"
+#include "transaction.hpp"
+
+//////////////////////////////////////////////////////////////////////////////
+
+namespace sqlitepp {
+
+//////////////////////////////////////////////////////////////////////////////
+
+// Group commit of writes submitted from many threads. Noncopyable.
+// The batcher owns a writer session used only by its worker thread.
+// Writes are queued lock-free and executed in one transaction per batch,
+// each write in its own nested transaction, so a failed write is rolled
+// back alone. Futures of a batch become ready after the batch is committed.
+class SQLITEPP_API write_batcher
+{
+public:
+    struct options
+    {
+        options() noexcept
+            : max_batch(1000)
+            , max_delay(0)
+            , txn_type(transaction::immediate)
+        {
+        }
+
+        // Maximal number of writes in one transaction.
+        std::size_t max_batch;
+        // Maximal time a batch waits for more writes since its first one.
+        // Zero commits as soon as the queue is drained.
+        std::chrono::microseconds max_delay;
+        // Type of batch transaction.
+        transaction::type txn_type;
+    };
+
+    // Open writer session and start worker thread.
+    explicit write_batcher(text const& filename, options const& opts = options(),
+                           unsigned flags = session::read | session::write | session::create);
+
+    write_batcher(write_batcher const&) = delete;
+    write_batcher& operator=(write_batcher const&) = delete;
+
+    // Execute queued writes and stop.
+    ~write_batcher();
+
+    // Queue write f(session&), could be called from any thread.
+    // The future holds f result or its exception, or commit exception.
+    template<typename F>
+    auto submit(F f) -> std::future<decltype(f(std::declval<session&>()))>
+    {
+        typedef decltype(f(std::declval<session&>())) R;
+        std::unique_ptr<task<F, R>> t(new task<F, R>(std::move(f)));
+        auto r = t->promise.get_future();
+        push(std::move(t));
+        return r;
+    }
+
+    // Execute queued writes and stop worker thread. Later submits throw.
+    void stop();
+
+    // Number of committed batches.
+    unsigned long long batches() const noexcept;
+
+    // Number of executed writes, including failed ones.
+    unsigned long long writes() const noexcept;
+
+private:
+    struct node
+    {
+        std::atomic<node*> next{nullptr};
+        virtual ~node() = default;
+        // Execute write.
+        virtual void run(session& s) = 0;
+        // Write is committed.
+        virtual void done() = 0;
+        // Write or its commit failed.
+        virtual void fail(std::exception_ptr e) = 0;
+    };
+
+    template<typename F, typename R>
+    struct task : node
+    {
+        explicit task(F&& f) : f(std::move(f)) {}
+        void run(session& s) override { result.reset(new R(f(s))); }
+        void done() override { promise.set_value(std::move(*result)); }
+        void fail(std::exception_ptr e) override { promise.set_exception(e); }
+
+        F f;
+        std::unique_ptr<R> result;
+        std::promise<R> promise;
+    };
+
+    template<typename F>
+    struct task<F, void> : node
+    {
+        explicit task(F&& f) : f(std::move(f)) {}
+        void run(session& s) override { f(s); }
+        void done() override { promise.set_value(); }
+        void fail(std::exception_ptr e) override { promise.set_exception(e); }
+
+        F f;
+        std::promise<void> promise;
+    };
+
+    // Enqueue by producers.
+    void push(std::unique_ptr<node> n);
+    void link(node* n) noexcept;
+
+    // Dequeue by worker, null if queue is empty.
+    node* pop() noexcept;
+    // Wait until queue is not empty or time point, null on timeout or stop.
+    node* pop_wait(std::chrono::steady_clock::time_point until);
+
+    void run();
+    void run_batch(node* first);
+
+    session db_;
+    options const opts_;
+
+    // Intrusive multi-producer single-consumer queue.
+    std::atomic<node*> tail_; // producers end
+    node* head_;              // consumer end
+    struct stub : node
+    {
+        void run(session&) override {}
+        void done() override {}
+        void fail(std::exception_ptr) override {}
+    } stub_;
+
+    std::atomic<bool> stopped_;
+    std::atomic<bool> sleeping_;
+    // Producers between the stopped check and linking their node.
+    std::atomic<unsigned> pushers_;
+    std::mutex mutex_;
+    std::condition_variable wakeup_;
+
+    std::atomic<unsigned long long> batches_;
+    std::atomic<unsigned long long> writes_;
+
+    std::thread worker_;
+};
+
+//////////////////////////////////////////////////////////////////////////////
+
+} // namespace sqlitepp
+
+//////////////////////////////////////////////////////////////////////////////
+
+#endif // SQLITEPP_WRITE_BATCHER_HPP_INCLUDED
+
+//////////////////////////////////////////////////////////////////////////////
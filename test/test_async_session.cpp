@@ -0,0 +1,216 @@
+#include <chrono>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+#include <tut.h>
+
+#include <sqlitepp/async_session.hpp>
+#include <sqlitepp/exception.hpp>
+#include <sqlitepp/into.hpp>
+
+#include <sqlite3.h>
+
+#include "session_data.hpp"
+
+using namespace sqlitepp;
+
+namespace tut {
+
+struct async_session_data : session_data
+{
+    async_session_data()
+    {
+        se << utf("create table t(id integer, name text)");
+    }
+};
+
+typedef tut::test_group<async_session_data> async_session_test_group;
+typedef async_session_test_group::object object;
+
+async_session_test_group as_g("18. async session");
+
+#ifdef SQLITEPP_HAS_COROUTINES
+// Coroutine started at once, never awaited.
+struct detached
+{
+    struct promise_type
+    {
+        detached get_return_object() { return detached(); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_never final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+};
+
+detached insert_and_count(async_session& db, std::promise<std::size_t>& count)
+{
+    co_await db.exec("insert into t values(?, ?)", 10, u8string("coroutine"));
+    auto rows = co_await db.query<int>("select id from t");
+    count.set_value(rows.size());
+}
+#endif
+
+// operations
+template<>template<>
+void object::test<1>()
+{
+    async_session db(name_);
+
+    async_result<std::size_t> inserted = db.exec("insert into t values(?, ?), (?, ?)",
+        1, u8string("one"), 2, u8string("two"));
+    ensure_equals("changes", inserted.get(), 2u);
+
+    auto rows = db.query<int, u8string>("select id, name from t where id > ? order by id", 0).get();
+    ensure_equals("rows", rows.size(), 2u);
+    ensure_equals("id", std::get<0>(rows[1]), 2);
+    ensure_equals("name", std::get<1>(rows[1]), u8string("two"));
+
+    auto count = db.transaction([](session& s)
+    {
+        s << "insert into t values(3, 'three')";
+        int n = 0;
+        s << "select count(*) from t", into(n);
+        return n;
+    }, transaction::immediate);
+    ensure_equals("in transaction", count.get(), 3);
+
+    // failed transaction is rolled back
+    auto failed = db.transaction([](session& s)
+    {
+        s << "insert into t values(4, 'four')";
+        throw std::runtime_error("failed");
+    });
+    try
+    {
+        failed.get();
+        fail("exception expected");
+    }
+    catch (std::runtime_error const&)
+    {
+    }
+    try
+    {
+        db.exec("insert into no_table values(1)").get();
+        fail("exception expected");
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+
+    async_result<void> done = db.submit([](session& s) { s << "delete from t where id = 3"; });
+    done.get();
+    ensure("ready", done.ready());
+    ensure_equals("rolled back", db.query<int>("select id from t").get().size(), 2u);
+
+#ifdef SQLITEPP_HAS_COROUTINES
+    std::promise<std::size_t> coroutine_count;
+    insert_and_count(db, coroutine_count);
+    ensure_equals("coroutine", coroutine_count.get_future().get(), 3u);
+#endif
+
+    db.stop();
+    ensure("batches", db.batches() > 0);
+    try
+    {
+        db.exec("delete from t");
+        fail("exception expected");
+    }
+    catch (std::logic_error const&)
+    {
+    }
+}
+
+// batching and cancellation
+template<>template<>
+void object::test<2>()
+{
+    async_session db(name_);
+
+    // hold the worker until operations are queued
+    std::mutex m;
+    std::condition_variable cv;
+    bool release = false;
+    db.submit([&](session&)
+    {
+        std::unique_lock<std::mutex> lock(m);
+        cv.wait(lock, [&] { return release; });
+    });
+    unsigned long long const batches = db.batches();
+
+    std::vector<async_result<std::size_t>> inserts;
+    for (int i = 0; i < 10; ++i)
+    {
+        inserts.push_back(db.exec("insert into t values(?, 'x')", i));
+    }
+    inserts[5].cancel();
+    {
+        std::lock_guard<std::mutex> lock(m);
+        release = true;
+        cv.notify_one();
+    }
+    for (int i = 0; i < 10; ++i)
+    {
+        try
+        {
+            ensure_equals("inserted", inserts[i].get(), 1u);
+            ensure("not cancelled", i != 5);
+        }
+        catch (sqlitepp::exception const& e)
+        {
+            ensure_equals("cancelled", i, 5);
+            ensure_equals("interrupt", e.code(), SQLITE_INTERRUPT);
+        }
+    }
+    ensure("queued in one batch", db.batches() - batches <= 2);
+
+    // running statement is interrupted
+    auto endless = db.query<long long>(
+        "with recursive n(i) as (select 1 union all select i + 1 from n) select max(i) from n");
+    std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    ensure("running", !endless.ready());
+    db.cancel();
+    try
+    {
+        endless.get();
+        fail("exception expected");
+    }
+    catch (sqlitepp::exception const& e)
+    {
+        ensure_equals("interrupted", e.code(), SQLITE_INTERRUPT);
+    }
+    ensure_equals("usable", db.query<int>("select id from t").get().size(), 9u);
+}
+
+// cancel of running operation before its statement steps
+template<>template<>
+void object::test<3>()
+{
+    async_session db(name_);
+
+    std::promise<async_result<int>*> self;
+    std::shared_future<async_result<int>*> const submitted = self.get_future().share();
+    async_result<int> r = db.submit([submitted](session& s)
+    {
+        submitted.get()->cancel();
+        int n = 0;
+        s << "select 1", into(n);
+        return n;
+    });
+    self.set_value(&r);
+    try
+    {
+        r.get();
+        fail("exception expected");
+    }
+    catch (sqlitepp::exception const& e)
+    {
+        ensure_equals("interrupted", e.code(), SQLITE_INTERRUPT);
+    }
+    ensure_equals("usable", db.query<int>("select 1").get().size(), 1u);
+}
+
+} // namespace tut {
@@ -0,0 +1,121 @@
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include <tut.h>
+
+#include <sqlitepp/blob_stream.hpp>
+#include <sqlitepp/exception.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "statement_data.hpp"
+
+using namespace sqlitepp;
+
+namespace tut {
+
+struct blob_stream_data : statement_data
+{
+    // Insert row with zeroblob of size bytes.
+    void insert(int id, std::size_t size)
+    {
+        blob const b = { nullptr, size };
+        se << utf("insert into some_table(id, data) values(:id, :data)"), use(id), use(b);
+    }
+};
+
+typedef tut::test_group<blob_stream_data> blob_stream_test_group;
+typedef blob_stream_test_group::object object;
+
+blob_stream_test_group bs_g("15. blob stream");
+
+// stream write and read, reopen
+template<>template<>
+void object::test<1>()
+{
+    insert(1, 10000);
+    insert(2, 3);
+
+    {
+        blob_stream bs(se, utf("some_table"), utf("data"), 1, true, 256);
+        ensure_equals("size", bs.size(), 10000u);
+        std::ostream out(&bs);
+        for (int i = 0; i < 1000; ++i) out << "0123456789";
+        ensure("written", out.good());
+        out << 'x';
+        ensure("no room", !out.good());
+
+        bs.reopen(2);
+        ensure_equals("reopened size", bs.size(), 3u);
+        out.clear();
+        out << "abc" << std::flush;
+        ensure("written after reopen", out.good());
+    }
+
+    blob_stream bs(se, utf("some_table"), utf("data"), 1, false, 256);
+    std::istream in(&bs);
+    std::string s;
+    in >> s;
+    ensure_equals("read size", s.size(), 10000u);
+    ensure_equals("read tail", s.substr(9990), std::string("0123456789"));
+
+    char chunk[8];
+    ensure_equals("chunk", bs.read(9995, chunk, sizeof(chunk)), 5u);
+    ensure_equals("chunk data", std::string(chunk, 5), std::string("56789"));
+
+    bs.reopen(2);
+    std::string abc(3, ' ');
+    in.clear();
+    in.read(&abc[0], 3);
+    ensure_equals("reopened data", abc, std::string("abc"));
+}
+
+// seek, large reads, errors
+template<>template<>
+void object::test<2>()
+{
+    insert(1, 1000);
+
+    blob_stream bs(se, utf("some_table"), utf("data"), 1, true, 16);
+    std::iostream io(&bs);
+    io.seekp(500);
+    io << "hello";
+    io.seekg(495);
+    std::string s(20, ' ');
+    io.read(&s[0], 20);
+    ensure_equals("large read", s, std::string(5, '\0') + "hello" + std::string(10, '\0'));
+    ensure_equals("position", static_cast<int>(io.tellg()), 515);
+
+    try
+    {
+        bs.write(998, "abc", 3);
+        fail( "exception expected" );
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+    bs.close();
+    ensure("closed", !bs.is_open());
+
+    blob_stream ro(se, utf("some_table"), utf("data"), 1);
+    try
+    {
+        ro.write(0, "abc", 3);
+        fail( "exception expected" );
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+
+    try
+    {
+        blob_stream no_row(se, utf("some_table"), utf("data"), 42);
+        fail( "exception expected" );
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+}
+
+} // namespace tut {
@@ -0,0 +1,258 @@
+#include <tut.h>
+
+#include <sqlitepp/bulk_insert.hpp>
+#include <sqlitepp/exception.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "statement_data.hpp"
+
+using namespace sqlitepp;
+
+namespace tut {
+
+struct bulk_insert_data : statement_data
+{
+    int count()
+    {
+        int n = 0;
+        se << utf("select count(*) from some_table"), into(n);
+        return n;
+    }
+};
+
+typedef tut::test_group<bulk_insert_data> bulk_insert_test_group;
+typedef bulk_insert_test_group::object object;
+
+bulk_insert_test_group bi_g("14. bulk insert");
+
+// rows, tuples, structs and columns
+template<>template<>
+void object::test<1>()
+{
+    bulk_insert bi(se, utf("insert into some_table(id, name, salary) values(?, ?, ?)"));
+    bi.insert(1, utf("one"), 1.5);
+    bi.insert(std::make_tuple(2, string_t(utf("two")), 2.5));
+
+    std::vector<record> recs;
+    recs.push_back(record(3, utf("three"), 3.5));
+    recs.push_back(record(4, utf("four"), 4.5));
+    bi.insert_rows(recs, [](record const& r) { return std::tie(r.id, r.name, r.salary); });
+
+    std::vector<int> ids = { 5, 6, 7 };
+    std::vector<string_t> names = { utf("five"), utf("six"), utf("seven") };
+    std::vector<double> salaries = { 5.5, 6.5, 7.5 };
+    bi.insert_columns(ids, names, salaries);
+    bi.finish();
+
+    bulk_insert::stats const st = bi.statistics();
+    ensure_equals("rows", st.rows, 7u);
+    ensure_equals("chunks", st.chunks, 1u);
+    ensure("rows per second", st.rows_per_second > 0);
+    ensure_equals("count", count(), 7);
+
+    string_t name;
+    double salary = 0;
+    se << utf("select name, salary from some_table where id = 6"), into(name), into(salary);
+    ensure_equals("name", name, utf("six"));
+    ensure_equals("salary", salary, 6.5);
+}
+
+// rows are committed in chunks, the rest is rolled back without finish
+template<>template<>
+void object::test<2>()
+{
+    bulk_insert::options opts;
+    opts.chunk_size = 10;
+    {
+        bulk_insert bi(se, utf("insert into some_table(id) values(?)"), opts);
+        for (int i = 0; i < 25; ++i) bi.insert(i);
+        ensure_equals("chunks", bi.statistics().chunks, 2u);
+    }
+    ensure_equals("committed rows", count(), 20);
+}
+
+// value count and column sizes are checked
+template<>template<>
+void object::test<3>()
+{
+    bulk_insert bi(se, utf("insert into some_table(id, name) values(?, ?)"));
+    try
+    {
+        bi.insert(1);
+        fail("exception expected");
+    }
+    catch (std::invalid_argument const&)
+    {
+    }
+
+    std::vector<int> ids = { 1, 2 };
+    std::vector<string_t> names = { utf("one") };
+    try
+    {
+        bi.insert_columns(ids, names);
+        fail("exception expected");
+    }
+    catch (std::invalid_argument const&)
+    {
+    }
+    bi.finish();
+    ensure_equals("count", count(), 0);
+}
+
+// chunks nest in an active transaction
+template<>template<>
+void object::test<4>()
+{
+    bulk_insert::options opts;
+    opts.chunk_size = 2;
+    {
+        transaction txn(se);
+        bulk_insert bi(se, utf("insert into some_table(id) values(?)"), opts);
+        for (int i = 0; i < 5; ++i) bi.insert(i);
+        bi.finish();
+        ensure_equals("rows in transaction", count(), 5);
+    }
+    ensure_equals("rolled back with outer transaction", count(), 0);
+}
+
+// multi-row VALUES batches and tail statement
+template<>template<>
+void object::test<5>()
+{
+    bulk_insert::options opts;
+    opts.batch_rows = 4;
+    opts.chunk_size = 10;
+    {
+        bulk_insert bi(se, utf("INSERT INTO some_table(id, name, salary, data) VALUES (?, ?, ?, ?)"), opts);
+        ensure_equals("batch rows", bi.batch_rows(), 4u);
+        std::vector<char> const data(3, 'x');
+        for (int i = 0; i < 25; ++i)
+        {
+            if ( i % 2 ) bi.insert(i, utf("name ") + std::to_string(i), i * 0.5, data);
+            else bi.insert(i, nullptr, nullptr, nullptr);
+        }
+        // 20 rows in two chunks, one batch of 4 rows, the last row is buffered
+        ensure_equals("rows", bi.statistics().rows, 24u);
+        ensure_equals("chunks", bi.statistics().chunks, 2u);
+        ensure_equals("executed rows", count(), 24);
+        bi.finish();
+        ensure_equals("finished rows", bi.statistics().rows, 25u);
+    }
+    ensure_equals("all rows", count(), 25);
+
+    int nulls = 0;
+    se << utf("select count(*) from some_table where name is null and salary is null and data is null"), into(nulls);
+    ensure_equals("null rows", nulls, 13);
+
+    string_t name;
+    double salary = 0;
+    std::vector<char> data;
+    se << utf("select name, salary, data from some_table where id = 23"), into(name), into(salary), into(data);
+    ensure_equals("name", name, utf("name 23"));
+    ensure_equals("salary", salary, 11.5);
+    ensure_equals("data", data.size(), 3u);
+}
+
+// batch size is limited by variable number, other statements are not batched
+template<>template<>
+void object::test<6>()
+{
+    bulk_insert::options opts;
+    opts.batch_rows = 0;
+    bulk_insert bi(se, utf("insert into some_table(id, name) values(?, 'va''lues(?)') -- values"), opts);
+    ensure("maximal batch", bi.batch_rows() > 1);
+    ensure("variable limit", bi.batch_rows() * 1 <= 250000u);
+    for (int i = 0; i < 1000; ++i) bi.insert(i);
+    bi.finish();
+    ensure_equals("rows", count(), 1000);
+
+    ensure_equals("named", bulk_insert(se, utf("insert into some_table(id) values(:id)"), opts).batch_rows(), 1u);
+    ensure_equals("numbered", bulk_insert(se, utf("insert into some_table(id) values(?1)"), opts).batch_rows(), 1u);
+    ensure_equals("multi-row", bulk_insert(se, utf("insert into some_table(id) values(?), (?)"), opts).batch_rows(), 1u);
+    ensure_equals("select", bulk_insert(se, utf("insert into some_table(id) select ?"), opts).batch_rows(), 1u);
+    ensure_equals("disabled", bulk_insert(se, utf("insert into some_table(id) values(?)")).batch_rows(), 1u);
+}
+
+// failed batch inserts none of its rows
+template<>template<>
+void object::test<7>()
+{
+    se << utf("create unique index some_index on some_table(id)");
+    bulk_insert::options opts;
+    opts.batch_rows = 3;
+    bulk_insert bi(se, utf("insert into some_table(id) values(?)"), opts);
+    bi.insert(1);
+    bi.insert(2);
+    try
+    {
+        bi.insert(1);
+        fail("exception expected");
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+    bi.insert(3);
+    bi.finish();
+    ensure_equals("rows", count(), 1);
+}
+
+// insert goes on after failed row or batch, only executed rows are counted
+template<>template<>
+void object::test<8>()
+{
+    se << utf("create unique index some_index on some_table(id)");
+    for (std::size_t batch_rows = 1; batch_rows <= 2; ++batch_rows)
+    {
+        se << utf("delete from some_table");
+        bulk_insert::options opts;
+        opts.batch_rows = batch_rows;
+        bulk_insert bi(se, utf("insert into some_table(id) values(?)"), opts);
+        bi.insert(1);
+        bi.insert(2);
+        ensure_equals("executed rows", bi.statistics().rows, 2u);
+        try
+        {
+            bi.insert(1);
+            if ( batch_rows > 1 ) bi.insert(5);
+            fail("exception expected");
+        }
+        catch (sqlitepp::exception const&)
+        {
+        }
+        ensure_equals("failed rows", bi.statistics().rows, 2u);
+        bi.insert(3);
+        bi.insert(4);
+        ensure_equals("rows after failure", bi.statistics().rows, 4u);
+        bi.finish();
+        ensure_equals("committed rows", count(), 4);
+        ensure_equals("chunks", bi.statistics().chunks, 1u);
+    }
+}
+
+// blob without data is a zeroblob of its size, with or without batching
+template<>template<>
+void object::test<9>()
+{
+    for (std::size_t batch_rows = 1; batch_rows <= 2; ++batch_rows)
+    {
+        se << utf("delete from some_table");
+        bulk_insert::options opts;
+        opts.batch_rows = batch_rows;
+        bulk_insert bi(se, utf("insert into some_table(id, data) values(?, ?)"), opts);
+        blob const zeros = { nullptr, 5 };
+        blob const empty = { nullptr, 0 };
+        bi.insert(1, zeros);
+        bi.insert(2, empty);
+        bi.finish();
+
+        int size = 0;
+        se << utf("select length(data) from some_table where id = 1 and data = zeroblob(5)"), into(size);
+        ensure_equals("zeroblob", size, 5);
+        int nulls = 0;
+        se << utf("select count(*) from some_table where id = 2 and data is null"), into(nulls);
+        ensure_equals("null", nulls, 1);
+    }
+}
+
+} // namespace
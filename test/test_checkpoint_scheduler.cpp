@@ -0,0 +1,131 @@
+#include <chrono>
+#include <thread>
+
+#include <tut.h>
+
+#include <sqlitepp/checkpoint_scheduler.hpp>
+#include <sqlitepp/exception.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/session_options.hpp>
+
+#include <sqlite3.h>
+
+#include "session_data.hpp"
+
+using namespace sqlitepp;
+
+namespace tut {
+
+struct checkpoint_data : session_data
+{
+    checkpoint_data()
+    {
+        session_options opts;
+        opts.journal = session_options::journal_mode::wal;
+        se.apply(opts);
+        se << utf("create table t(id integer, data blob)");
+    }
+
+    // Wait until f() or timeout.
+    template<typename F>
+    bool wait(F f)
+    {
+        for (int i = 0; i < 200 && !f(); ++i)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return f();
+    }
+
+    void insert(int rows)
+    {
+        for (int i = 0; i < rows; ++i)
+        {
+            se << utf("insert into t values(") << i << utf(", zeroblob(4000))");
+        }
+    }
+};
+
+typedef tut::test_group<checkpoint_data> checkpoint_test_group;
+typedef checkpoint_test_group::object object;
+
+checkpoint_test_group cs_g("16. checkpoint scheduler");
+
+// checkpoint on WAL size
+template<>template<>
+void object::test<1>()
+{
+    checkpoint_scheduler::options opts;
+    opts.wal_pages = 20;
+    opts.interval = std::chrono::milliseconds(0);
+    checkpoint_scheduler cs(se, name_, opts);
+
+    insert(30);
+    ensure("checkpointed", wait([&] { return cs.statistics().checkpoints > 0; }));
+    checkpoint_scheduler::stats const st = cs.statistics();
+    ensure("max wal pages", st.max_wal_pages >= 20);
+    ensure_equals("no error", st.last_error, 0);
+    ensure("frames", st.last_log_frames > 0);
+    ensure("duration", st.total_duration >= st.last_duration);
+}
+
+// requested and periodic checkpoints
+template<>template<>
+void object::test<2>()
+{
+    checkpoint_scheduler::options opts;
+    opts.wal_pages = 1000000;
+    opts.interval = std::chrono::milliseconds(0);
+    {
+        checkpoint_scheduler cs(se, name_, opts);
+        insert(5);
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        ensure_equals("below threshold", cs.statistics().checkpoints, 0u);
+        ensure("wal pages", cs.statistics().wal_pages > 0);
+
+        cs.request(checkpoint_scheduler::truncate);
+        ensure("requested", wait([&] { return cs.statistics().checkpoints == 1; }));
+        ensure_equals("complete", cs.statistics().incomplete, 0u);
+    }
+
+    opts.interval = std::chrono::milliseconds(10);
+    checkpoint_scheduler cs(se, name_, opts);
+    insert(1);
+    ensure("periodic", wait([&] { return cs.statistics().checkpoints > 0; }));
+}
+
+// incomplete checkpoint is retried, automatic checkpoints are restored
+template<>template<>
+void object::test<3>()
+{
+    sqlite3_wal_autocheckpoint(se.impl(), 123);
+    {
+        checkpoint_scheduler::options opts;
+        opts.wal_pages = 1000000;
+        opts.interval = std::chrono::milliseconds(10);
+        checkpoint_scheduler cs(se, name_, opts);
+
+        // reader snapshot keeps later frames from being checkpointed
+        session reader(name_);
+        reader << utf("begin");
+        int rows = 0;
+        reader << utf("select count(*) from t"), into(rows);
+        insert(5);
+        ensure("retried", wait([&] { return cs.statistics().incomplete >= 3; }));
+
+        reader << utf("commit");
+        ensure("complete", wait([&]
+        {
+            checkpoint_scheduler::stats const st = cs.statistics();
+            return st.last_error == 0 && st.last_checkpointed_frames == st.last_log_frames;
+        }));
+        unsigned long long const checkpoints = cs.statistics().checkpoints;
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        ensure_equals("nothing pending", cs.statistics().checkpoints, checkpoints);
+    }
+    int autocheckpoint = 0;
+    se << utf("pragma wal_autocheckpoint"), into(autocheckpoint);
+    ensure_equals("restored", autocheckpoint, 123);
+}
+
+} // namespace tut {
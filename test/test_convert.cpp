@@ -2,6 +2,9 @@
 #include <cstdio>
 #include <cstring>
 #include <ctime>
+#if __cplusplus >= 201703L
+#include <string_view>
+#endif
 
 #include <tut.h>
 
@@ -161,4 +164,36 @@ void object::test<5>()
     ensure_equals("my_data", data2.value, data.value);
 }
 
+#if __cplusplus >= 201703L
+// string_view and u16string_view views of column values
+template<>template<>
+void object::test<6>()
+{
+    statement st(se);
+    st << utf("select 'abc', null, 'def'");
+    st.exec();
+
+    std::string_view const abc = st.get<std::string_view>(0);
+    ensure_equals("text", abc, "abc");
+    ensure("null", st.get<std::string_view>(1).data() == nullptr);
+    std::u16string_view const def = st.get<std::u16string_view>(2);
+    ensure("text16", def == u"def");
+    ensure("valid view", st.is_valid_view(abc.data()));
+    ensure("valid view16", st.is_valid_view(def.data()));
+
+    st.reset();
+#ifndef NDEBUG
+    ensure("view after reset", !st.is_valid_view(abc.data()));
+#endif
+
+    // bind not nul-terminated view
+    std::string_view const part = std::string_view("xyz").substr(0, 2);
+    statement st2(se);
+    std::string result;
+    st2 << utf("select :v"), into(result), use(part);
+    ensure("select", st2.exec());
+    ensure_equals("bound view", result, "xy");
+}
+#endif
+
 } // namespace tut {
@@ -1,7 +1,11 @@
+#include <cstring>
+#include <vector>
+
 #include <tut.h>
 
 #include <sqlitepp/exception.hpp>
 #include <sqlitepp/into.hpp>
+#include <sqlitepp/columns.hpp>
 #include "statement_data.hpp"
 
 using namespace sqlitepp;
@@ -84,4 +88,43 @@ void object::test<4>()
     ensure( "single row", !st.exec() );
 }
 
+// into_rows columns fetched in batches
+template<>template<>
+void object::test<5>()
+{
+    se << utf("insert into some_table(id, name, salary, data) values(1, 'one', 1.5, x'0102')");
+    se << utf("insert into some_table(id, name, salary, data) values(2, null, 2.5, null)");
+    se << utf("insert into some_table(id, name, salary, data) values(3, 'three', 3.5, x'03')");
+
+    std::vector<int> ids;
+    std::vector<double> salaries;
+    text_column names;
+    blob_column data;
+    st << utf("select id, name, salary, data from some_table order by id"),
+        into_rows(ids), into_rows(names), into_rows(salaries, utf("salary")), into_rows(data);
+
+    ensure_equals("first batch", st.fetch(2), 2u);
+    ensure_equals("ids", ids.size(), 2u);
+    ensure_equals("last batch", st.fetch(2), 1u);
+
+    ensure_equals("rows", ids.size(), 3u);
+    ensure_equals("rows", names.size(), 3u);
+    ensure_equals("rows", salaries.size(), 3u);
+    ensure_equals("rows", data.size(), 3u);
+    ensure_equals(ids[2], 3);
+    ensure_equals(salaries[1], 2.5);
+
+    ensure("text", !names.is_null(0) && std::strcmp(names[0].data, "one") == 0 && names[0].size == 3);
+    ensure("null text", names.is_null(1) && !names[1].data);
+    ensure_equals(names[2].size, 5u);
+    ensure_equals(names.bytes(), 10u);
+
+    ensure("blob", !data.is_null(0) && data[0].size == 2 && static_cast<char const*>(data[0].data)[1] == 2);
+    ensure("null blob", data.is_null(1) && !data[1].data);
+    ensure_equals(data[2].size, 1u);
+
+    names.clear();
+    ensure("cleared", names.empty());
+}
+
 } // namespace tut {
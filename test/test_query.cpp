@@ -1,5 +1,6 @@
 #include <tut.h>
 
+#include <iomanip>
 #include <locale>
 
 #include <sqlitepp/query.hpp>
@@ -99,4 +100,56 @@ void object::test<4>()
     ensure("cleared q2 uses", q2.uses().empty());
 }
 */
+
+// arithmetic values are formatted as by std::ostream
+template<>template<>
+void object::test<5>()
+{
+    q << "v" << -12 << ' ' << 34u << ' ' << -9223372036854775807ll - 1 << ' '
+      << 18446744073709551615ull << ' ' << true << ' ' << 23.44 << ' ' << 0.1f << ' ' << 1e100;
+    ensure_equals("numbers", q.sql(),
+        utf("v-12 34 -9223372036854775808 18446744073709551615 1 23.44 0.1 1e+100"));
+
+    std::ostringstream os;
+    os << 3.14159265358979 << ' ' << 1234567.0;
+    query q2;
+    q2 << 3.14159265358979 << ' ' << 1234567.0;
+    ensure_equals("same as ostream", q2.sql(), os.str());
+}
+
+// stream manipulators apply to subsequent values
+template<>template<>
+void object::test<6>()
+{
+    q << "x = " << std::setprecision(10) << 3.14159265358979 << " and " << std::hex << 255;
+    ensure_equals("manipulated", q.sql(), utf("x = 3.141592654 and ff"));
+
+    q.clear();
+    q << 3.14159265358979;
+    ensure_equals("reset on clear", q.sql(), utf("3.14159"));
+}
+
+// long text is moved from inline storage to heap
+template<>template<>
+void object::test<7>()
+{
+    string_t expected;
+    for (int i = 0; i < 100; ++i)
+    {
+        q << "select " << i << ";";
+        expected += utf("select ") + std::to_string(i) + utf(";");
+    }
+    ensure_equals("long sql", q.sql(), expected);
+    ensure_equals("sql_text size", q.sql_text().size, expected.size());
+
+    query q2;
+    q2 << "short";
+    q.swap(q2);
+    ensure_equals("swapped short", q.sql(), utf("short"));
+    ensure_equals("swapped long", q2.sql(), expected);
+
+    query q3(std::move(q2));
+    ensure_equals("moved", q3.sql(), expected);
+    ensure("moved from", q2.sql().empty());
+}
 } // namespace tut {
@@ -1,8 +1,16 @@
 #include <stdio.h>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <thread>
 #include <tut.h>
 
 #include "session_data.hpp"
 #include <sqlitepp/exception.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/statement.hpp>
+#include <sqlitepp/transaction.hpp>
+#include <sqlitepp/use.hpp>
 
 #include <sqlite3.h>
 
@@ -62,4 +70,266 @@ void object::test<3>()
     }
 }
 
+// tuning options and presets
+template<>template<>
+void object::test<4>()
+{
+    typedef session_options so;
+
+    so opts = so::oltp_wal();
+    opts.page_size = 8192;
+    se.open(name_, opts);
+    so const wal = se.options();
+    ensure("wal", wal.journal == so::journal_mode::wal);
+    ensure("synchronous", wal.sync == so::synchronous::normal);
+    ensure("temp store", wal.temp == so::temp_store::memory);
+    ensure_equals("page size", wal.page_size, 8192);
+    ensure_equals("cache size", wal.cache_size, -64 * 1024ll);
+    ensure("query only", wal.query_only == so::query_only_mode::off);
+
+    se.apply(so::read_only_analytics());
+    ensure("query only", se.options().query_only == so::query_only_mode::on);
+    try
+    {
+        se << utf("create table t(id integer)");
+        fail( "exception expected" );
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+    // keep leaves it on, off allows changes again
+    se.apply(so());
+    ensure("kept query only", se.options().query_only == so::query_only_mode::on);
+    so writable;
+    writable.query_only = so::query_only_mode::off;
+    se.apply(writable);
+    ensure("query only off", se.options().query_only == so::query_only_mode::off);
+    se << utf("create table t(id integer)");
+    se.close();
+
+    session mem(utf(":memory:"), so::in_memory());
+    so const m = mem.options();
+    ensure("memory journal", m.journal == so::journal_mode::memory);
+    ensure("no sync", m.sync == so::synchronous::off);
+
+    // keep issues no pragma
+    so const before = mem.options();
+    mem.apply(so());
+    ensure_equals("kept cache size", mem.options().cache_size, before.cache_size);
+}
+
+// busy policy
+template<>template<>
+void object::test<5>()
+{
+    se << utf("create table t(id integer)");
+    session other(name_);
+    other.set_busy_policy(busy_policy::timeout(std::chrono::milliseconds(30)));
+
+    // locked for longer than timeout
+    {
+        transaction txn(se, transaction::exclusive);
+        try
+        {
+            other << utf("select count(*) from t");
+            fail( "exception expected" );
+        }
+        catch (sqlitepp::exception const& e)
+        {
+            ensure_equals("busy", e.code() & 0xff, SQLITE_BUSY);
+        }
+    }
+    busy_stats st = other.busy_statistics();
+    ensure_equals("events", st.events, 1u);
+    ensure_equals("timeouts", st.timeouts, 1u);
+    ensure("waited", st.total_wait >= std::chrono::milliseconds(30));
+    ensure_equals("histogram", st.histogram[5] + st.histogram[6] + st.histogram[7], 1u);
+
+    // lock released while waiting, begin is retried after timeout
+    busy_policy p;
+    p.initial_delay = p.max_delay = std::chrono::milliseconds(5);
+    p.max_wait = std::chrono::milliseconds(10);
+    p.jitter = 0;
+    p.txn_retries = 50;
+    other.set_busy_policy(p);
+    {
+        std::unique_ptr<transaction> txn(new transaction(se, transaction::exclusive));
+        std::thread unlock([&txn]
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            txn.reset();
+        });
+        transaction other_txn(other, transaction::immediate);
+        unlock.join();
+        other << utf("insert into t values(1)");
+        other_txn.commit();
+    }
+    st = other.busy_statistics();
+    ensure("retried", st.txn_retries > 0);
+    ensure("events", st.events > 1);
+    // the last event succeeded, unless the lock was released between retries
+    ensure("last event", st.events - st.timeouts <= 1);
+
+    other.clear_busy_policy();
+    ensure_equals("cleared", other.busy_statistics().events, 0u);
+}
+
+// metrics
+template<>template<>
+void object::test<6>()
+{
+    se << utf("create table t(id integer, name text)");
+    se << utf("insert into t values(1, 'a'), (2, 'b'), (3, 'c')");
+
+    session_metrics m = se.metrics();
+    ensure_equals("no timings", m.steps, 0u);
+    ensure("schema", m.schema_used > 0);
+
+    se.enable_timings(true);
+    int count = 0;
+    string_t const name = utf("a");
+    statement st(se);
+    st << utf("select count(*) from t where name = :name"), into(count), use(name, utf(":name"));
+    ensure("row", st.exec());
+    ensure_equals("count", count, 1);
+    ensure("done", !st.exec());
+    st.reset(true);
+    ensure("row again", st.exec());
+    st.reset();
+
+    statement_metrics sm = st.metrics(true);
+    ensure("fullscan", sm.fullscan_steps > 0);
+    ensure("vm steps", sm.vm_steps > 0);
+    ensure("memory", sm.memory_used > 0);
+    ensure_equals("reset", st.metrics().vm_steps, 0u);
+
+    m = se.metrics();
+    ensure_equals("prepares", m.prepares, 1u);
+    ensure_equals("steps", m.steps, 3u);
+    ensure_equals("binds", m.binds, 2u);
+    ensure("step time", m.step_time.count() > 0);
+
+    std::ostringstream os;
+    write_prometheus(os, m, "db=\"main\"");
+    ensure("steps sample", os.str().find("\nsqlitepp_steps_total{db=\"main\"} 3\n") != std::string::npos);
+    ensure("type", os.str().find("# TYPE sqlitepp_cache_hits_total counter\n") != std::string::npos);
+
+    os.str("");
+    m.step_time = std::chrono::nanoseconds(1234567891);
+    m.bind_time = std::chrono::nanoseconds(5);
+    write_prometheus(os, m);
+    ensure("exact seconds", os.str().find("\nsqlitepp_step_seconds_total 1.234567891\n") != std::string::npos);
+    ensure("small seconds", os.str().find("\nsqlitepp_bind_seconds_total 0.000000005\n") != std::string::npos);
+
+    os.str("");
+    write_prometheus(os, { { "query=\"a\"", sm }, { "query=\"b\"", statement_metrics() } });
+    std::string const out = os.str();
+    ensure_equals("one family", out.find("# TYPE sqlitepp_statement_sorts_total"),
+        out.rfind("# TYPE sqlitepp_statement_sorts_total"));
+    ensure("labels", out.find("sqlitepp_statement_sorts_total{query=\"b\"} 0\n") != std::string::npos);
+
+    se.enable_timings(false);
+    se << utf("select 1");
+    ensure_equals("disabled", se.metrics().steps, 3u);
+}
+
+// interrupt and deadlines
+template<>template<>
+void object::test<7>()
+{
+    string_t const endless = utf("with recursive n(i) as (select 1 union all select i + 1 from n) select max(i) from n");
+    auto const start = std::chrono::steady_clock::now();
+
+    se.set_deadline(start + std::chrono::milliseconds(30));
+    try
+    {
+        se << endless;
+        fail("exception expected");
+    }
+    catch (deadline_exceeded const& e)
+    {
+        ensure_equals("code", e.code(), SQLITE_INTERRUPT);
+    }
+    ensure("stopped soon", std::chrono::steady_clock::now() - start < std::chrono::seconds(5));
+    se.clear_deadline();
+    se << utf("select 1");
+
+    // statement timeout counts from the start of each run
+    long long max = 0;
+    statement st(se);
+    st << endless, into(max);
+    st.set_timeout(std::chrono::milliseconds(20));
+    for (int run = 0; run < 2; ++run)
+    {
+        try
+        {
+            st.exec();
+            fail("exception expected");
+        }
+        catch (interrupted const& e)
+        {
+            ensure("deadline", dynamic_cast<deadline_exceeded const*>(&e) != nullptr);
+        }
+    }
+    st << utf("select 1"), into(max);
+    ensure("row", st.exec());
+    st.reset();
+
+    std::thread other([this]
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(30));
+        se.interrupt();
+    });
+    try
+    {
+        se << endless;
+        fail("exception expected");
+    }
+    catch (interrupted const& e)
+    {
+        ensure("not deadline", dynamic_cast<deadline_exceeded const*>(&e) == nullptr);
+    }
+    other.join();
+
+    // interrupt of a commit after a deadline is not the deadline
+    {
+        // active statement keeps the interrupt for the commit
+        statement pending(se, utf("select 1 union all select 2"));
+        ensure("pending row", pending.exec());
+        transaction txn(se);
+        se.set_deadline(std::chrono::steady_clock::now() + std::chrono::milliseconds(10));
+        try
+        {
+            se << endless;
+            fail("exception expected");
+        }
+        catch (deadline_exceeded const&)
+        {
+        }
+        se.clear_deadline();
+        se.interrupt();
+        try
+        {
+            txn.commit();
+            fail("exception expected");
+        }
+        catch (interrupted const& e)
+        {
+            ensure("commit not deadline", dynamic_cast<deadline_exceeded const*>(&e) == nullptr);
+        }
+        pending.reset();
+    }
+    se << utf("select 1");
+
+    try
+    {
+        se.set_deadline_granularity(0);
+        fail("exception expected");
+    }
+    catch (sqlitepp::exception const& e)
+    {
+        ensure_equals("range", e.code(), SQLITE_RANGE);
+    }
+}
+
 } // namespace tut {
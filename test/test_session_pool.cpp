@@ -0,0 +1,127 @@
+#include <stdio.h>
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <tut.h>
+
+#include <sqlitepp/session_pool.hpp>
+#include <sqlitepp/exception.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "session_data.hpp"
+
+using namespace sqlitepp;
+
+namespace tut {
+
+struct session_pool_data : session_data
+{
+    session_pool_data() : session_data(utf("pool.db"))
+    {
+        se << utf("create table t(id integer primary key, value integer)");
+        se << utf("insert into t(value) values(42)");
+    }
+
+    ~session_pool_data()
+    {
+        // se was opened before WAL mode, so it does not remove WAL files
+        remove((utf8(name_) + "-wal").c_str());
+        remove((utf8(name_) + "-shm").c_str());
+    }
+
+    static session_pool::options wal(std::size_t readers)
+    {
+        session_pool::options opts;
+        opts.readers = readers;
+        opts.pragmas.push_back(utf("pragma journal_mode = wal"));
+        opts.pragmas.push_back(utf("pragma busy_timeout = 10000"));
+        return opts;
+    }
+};
+
+typedef tut::test_group<session_pool_data> session_pool_test_group;
+typedef session_pool_test_group::object object;
+
+session_pool_test_group sp_g("12. session pool");
+
+// readers and writer leases
+template<>template<>
+void object::test<1>()
+{
+    session_pool pool(name_, wal(2));
+    {
+        session_pool::lease w = pool.write();
+        *w << utf("insert into t(value) values(43)");
+    }
+
+    session_pool::lease r1 = pool.read();
+    session_pool::lease r2 = pool.read();
+    ensure("different readers", r1.get() != r2.get());
+
+    int count;
+    *r1 << utf("select count(*) from t"), into(count);
+    ensure_equals("count", count, 2);
+
+    try
+    {
+        *r2 << utf("insert into t(value) values(44)");
+        fail("exception expected");
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+
+    session_pool::stats const st = pool.read_stats();
+    ensure_equals("size", st.size, 2u);
+    ensure_equals("in use", st.in_use, 2u);
+    ensure_equals("leases", st.leases, 2u);
+    ensure_equals("no waits", st.waits, 0u);
+
+    r1.release();
+    ensure("released", !r1);
+    ensure_equals("in use", pool.read_stats().in_use, 1u);
+    ensure_equals("writer leases", pool.write_stats().leases, 1u);
+}
+
+// threads wait for free sessions
+template<>template<>
+void object::test<2>()
+{
+    session_pool pool(name_, wal(2));
+    std::atomic<int> sum(0);
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; ++t)
+    {
+        threads.emplace_back([&]
+        {
+            for (int i = 0; i < 20; ++i)
+            {
+                int value;
+                session_pool::lease r = pool.read();
+                *r << utf("select value from t where id = 1"), into(value);
+                sum += value;
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    ensure_equals("sum", sum.load(), 8 * 20 * 42);
+    session_pool::stats const st = pool.read_stats();
+    ensure_equals("leases", st.leases, 8u * 20u);
+    ensure_equals("returned", st.in_use, 0u);
+    ensure("utilization", st.utilization >= 0.0 && st.utilization <= 1.0);
+}
+
+// readers share the writer
+template<>template<>
+void object::test<3>()
+{
+    session_pool pool(name_, wal(0));
+    session* const w = pool.write().get();
+    ensure_equals("reader is writer", pool.read().get(), w);
+    ensure_equals("shared stats", pool.read_stats().leases, 2u);
+}
+
+} // namespace tut {
@@ -0,0 +1,149 @@
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include <tut.h>
+
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/slow_query_log.hpp>
+#include <sqlitepp/statement.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "session_data.hpp"
+
+using namespace sqlitepp;
+
+namespace tut {
+
+struct slow_query_data : session_data
+{
+    slow_query_data()
+    {
+        se << utf("create table t(id integer, name text)");
+        se << utf("create index t_name on t(name)");
+        se << utf("insert into t values(1, 'a'), (2, 'b'), (3, 'c')");
+    }
+};
+
+typedef tut::test_group<slow_query_data> slow_query_test_group;
+typedef slow_query_test_group::object object;
+
+slow_query_test_group sq_g("17. slow query log");
+
+// records with expanded sql and plan
+template<>template<>
+void object::test<1>()
+{
+    slow_query_log log(se, std::chrono::nanoseconds(0));
+
+    int id = 0;
+    string_t name = utf("b");
+    statement st(se);
+    st << utf("select id from t where name = ?"), into(id), use(name);
+    ensure("row", st.exec());
+    ensure_equals("id", id, 2);
+    st.reset(true);
+    name = utf("c");
+    st.reset(true);
+    ensure("row", st.exec());
+    st.reset();
+
+    std::vector<slow_query_log::record> records;
+    ensure_equals("records", log.drain(records), 2u);
+    ensure_equals("expanded", records[0].sql, "select id from t where name = 'b'");
+    ensure_equals("normalized", records[0].normalized_sql, "select id from t where name = ?");
+    ensure_equals("second", records[1].sql, "select id from t where name = 'c'");
+    ensure("steps", records[0].steps > 0);
+    ensure("plan", records[0].plan && records[0].plan->find("SEARCH t USING INDEX t_name (name=?)") != std::string::npos);
+    ensure_equals("plan captured once", records[0].plan, records[1].plan);
+    ensure_equals("drained", log.drain(records), 0u);
+
+    slow_query_log slow(se, std::chrono::hours(1));
+    se << utf("select count(*) from t");
+    ensure_equals("below threshold", slow.drain(records), 0u);
+}
+
+// full buffer and concurrent drain
+template<>template<>
+void object::test<2>()
+{
+    {
+        slow_query_log::options opts;
+        opts.capacity = 2;
+        slow_query_log log(se, std::chrono::nanoseconds(0), opts);
+        for (int i = 0; i < 4; ++i)
+        {
+            se << utf("select count(*) from t");
+        }
+        ensure_equals("dropped", log.dropped(), 2u);
+        std::size_t count = log.drain([](slow_query_log::record const& r)
+        {
+            ensure_equals("sql", r.sql, "select count(*) from t");
+        });
+        ensure_equals("kept", count, 2u);
+    }
+
+    slow_query_log::options opts;
+    opts.capacity = 16;
+    slow_query_log log(se, std::chrono::nanoseconds(0), opts);
+    std::atomic<bool> done(false);
+    std::size_t drained = 0;
+    std::thread consumer([&]
+    {
+        std::vector<slow_query_log::record> records;
+        while ( !done )
+        {
+            drained += log.drain(records);
+        }
+        drained += log.drain(records);
+        for (auto const& r : records)
+        {
+            ensure_equals("sql", r.normalized_sql, "select count(*) from t");
+        }
+    });
+    for (int i = 0; i < 1000; ++i)
+    {
+        se << utf("select count(*) from t");
+    }
+    done = true;
+    consumer.join();
+    ensure_equals("all runs", drained + log.dropped(), 1000u);
+}
+
+// least recently used plans are dropped
+template<>template<>
+void object::test<3>()
+{
+    slow_query_log::options opts;
+    opts.max_plans = 2;
+    slow_query_log log(se, std::chrono::nanoseconds(0), opts);
+    char const* const queries[] =
+    {
+        "select count(*) from t",
+        "select max(id) from t",
+        "select count(*) from t",
+        "select min(id) from t",
+        "select count(*) from t",
+        "select max(id) from t",
+    };
+    for (char const* sql : queries)
+    {
+        se << sql;
+    }
+
+    std::vector<slow_query_log::record> records;
+    ensure_equals("records", log.drain(records), 6u);
+    ensure("plan", records[0].plan && !records[0].plan->empty());
+    ensure_equals("recently used", records[2].plan, records[0].plan);
+    ensure_equals("kept", records[4].plan, records[0].plan);
+    ensure("dropped", records[5].plan != records[1].plan);
+    ensure_equals("captured again", *records[5].plan, *records[1].plan);
+
+    opts.max_plans = 0;
+    slow_query_log no_plans(se, std::chrono::nanoseconds(0), opts);
+    se << utf("select count(*) from t");
+    ensure_equals("record", no_plans.drain(records), 1u);
+    ensure("no plan", !records.back().plan);
+}
+
+} // namespace tut {
@@ -1,13 +1,19 @@
+#include <algorithm>
 #include <cmath>
 #include <iterator>
+#include <stdexcept>
+#include <tuple>
 #include <tut.h>
 #include <sqlitepp/exception.hpp>
+#include <sqlitepp/into.hpp>
 
 #include "statement_data.hpp"
 
 using namespace sqlitepp;
 
-// for tut::ensure_equals
+namespace std {
+
+// for tut::ensure_equals, must be found by ADL
 std::ostream& operator<<(std::ostream& os, statement_data::record::blob_data const& blob)
 {
     os << '[' << blob.size() << "] = (";
@@ -16,6 +22,8 @@ std::ostream& operator<<(std::ostream& os, statement_data::record::blob_data con
     return os;
 }
 
+} // namespace std
+
 statement_data::statement_data() : st(se)
 {
     se << utf("create table some_table(id integer, name text, salary real(8), data blob)");
@@ -160,4 +168,237 @@ void object::test<5>()
     st.reset();
 }
 
+// columns are readable only in a current row
+template<>template<>
+void object::test<6>()
+{
+    record r(1, utf("Alesha"), 123.45);
+    r.insert(se);
+
+    st << utf("select id, name from some_table");
+    st.prepare();
+    ensure_equals("col count before exec", st.column_count(), 2);
+    ensure("row", st.exec());
+    ensure_equals("col 0 value", st.get<int>(0), 1);
+    try
+    {
+        st.get<int>(-1);
+        fail( "range exception expected" );
+    }
+    catch (sqlitepp::exception const& e)
+    {
+        ensure_equals("negative column", e.code(), 25); // SQLITE_RANGE
+    }
+    try
+    {
+        st.get<int>(2);
+        fail( "range exception expected" );
+    }
+    catch (sqlitepp::exception const& e)
+    {
+        ensure_equals("column out of range", e.code(), 25);
+    }
+
+    ensure("no more rows", !st.exec());
+    try
+    {
+        st.get<int>(0);
+        fail( "range exception expected" );
+    }
+    catch (sqlitepp::exception const& e)
+    {
+        ensure_equals("no current row", e.code(), 25);
+    }
+}
+
+// column lookup by name and column_ref
+template<>template<>
+void object::test<7>()
+{
+    record(1, utf("Alesha"), 123.45).insert(se);
+    record(2, utf("Boris"), 678.9).insert(se);
+
+    st << utf("select id, name, salary, id as name2, name from some_table order by id");
+    st.prepare();
+    ensure_equals("id", st.column_index(utf("id")), 0);
+    ensure_equals("first of duplicates", st.column_index(utf("name")), 1);
+    ensure_equals("alias", st.column_index(utf("name2")), 3);
+    try
+    {
+        st.column_index(utf("Name"));
+        fail( "exception expected" );
+    }
+    catch (no_such_column const&)
+    {
+    }
+
+    column_ref const id = st.column(utf("id"));
+    column_ref const name = st.column(utf("name"));
+    ensure("row 1", st.exec());
+    ensure_equals("id 1", id.get<int>(), 1);
+    ensure_equals("name 1", name.get<string_t>(), utf("Alesha"));
+    ensure_equals("name type", name.type(), statement::text);
+    ensure("row 2", st.exec());
+    ensure_equals("id 2", id.get<int>(), 2);
+    st.reset();
+    ensure("row 1 after reset", st.exec());
+    ensure_equals("id after reset", id.get<int>(), 1);
+
+    // prepared again with other columns, column_ref follows
+    st << utf("select name, id from some_table order by id desc");
+    ensure("row 2", st.exec());
+    ensure_equals("id index", id.index(), 1);
+    ensure_equals("id reprepared", id.get<int>(), 2);
+    ensure_equals("name reprepared", name.get<string_t>(), utf("Boris"));
+
+    st.reset();
+}
+
+// rows range
+template<>template<>
+void object::test<8>()
+{
+    record(1, utf("Alesha"), 100).insert(se);
+    record(2, utf("Boris"), 200).insert(se);
+    record(3, utf("Vova"), 300).insert(se);
+
+    st << utf("select id, name, salary from some_table order by id");
+    int ids = 0;
+    std::size_t length = 0;
+    for (row const& r : st.rows())
+    {
+        ensure_equals("size", r.size(), 3);
+        ids += r.get<int>(0);
+        length += r.get<text>(utf("name")).size;
+        ensure("not null", !r.is_null(1));
+    }
+    ensure_equals("ids", ids, 6);
+    ensure_equals("name length", length, 15u);
+
+    // next range executes statement again
+    auto const rows = st.rows();
+    ensure_equals("count", std::distance(rows.begin(), rows.end()), 3);
+    ensure_equals("count if", std::count_if(st.rows().begin(), st.rows().end(),
+        [](row const& r) { return r.get<double>(2) > 150; }), 2);
+
+    row_iterator it = st.rows().begin();
+    std::tuple<int, text, double> const first = it->as<int, text, double>();
+    ensure_equals("tuple id", std::get<0>(first), 1);
+    ensure_equals("tuple name", std::get<1>(first).size, 6u);
+#if __cplusplus >= 201703L
+    auto [id, name, salary] = (*++it).as<int, string_t, double>();
+    ensure_equals("bound id", id, 2);
+    ensure_equals("bound name", name, utf("Boris"));
+    ensure_distance("bound salary", salary, 200.0, 0.01);
+#endif
+    st.reset();
+
+    st << utf("select id from some_table where id > 10");
+    ensure("empty result", st.rows().begin() == st.rows().end());
+}
+
+// scan status and full scan guard
+template<>template<>
+void object::test<9>()
+{
+    for (int i = 1; i <= 10; ++i)
+    {
+        record(i, utf("name"), i * 100).insert(se);
+    }
+
+    std::vector<string_t> flagged;
+    unsigned long long flagged_steps = 0;
+    se.set_fullscan_guard(15, [&](text const& sql, unsigned long long steps)
+    {
+        flagged.push_back(utf(sql.data));
+        flagged_steps = steps;
+    });
+
+    int count = 0;
+    st << utf("select count(*) from some_table where salary > 0"), into(count);
+    ensure("row", st.exec());
+    ensure_equals("count", count, 10);
+    ensure("done", !st.exec());
+    ensure("below threshold", flagged.empty());
+
+    std::vector<scan_loop> const loops = st.scan_status(true);
+    if ( statement::has_scan_status() )
+    {
+        ensure_equals("loops", loops.size(), 1u);
+        ensure_equals("name", loops[0].name, utf("some_table"));
+        ensure_equals("visited", loops[0].rows_visited, 10u);
+        ensure_distance("actual", loops[0].actual_rows(), 10.0, 0.01);
+        ensure("explain", loops[0].explain.find("SCAN some_table") == 0);
+        ensure("reset", st.scan_status()[0].rows_visited == 0);
+    }
+    else
+    {
+        ensure("unavailable", loops.empty());
+    }
+
+    // second run is past the threshold
+    st.reset();
+    ensure("row again", st.exec());
+    ensure("done again", !st.exec());
+    ensure_equals("flagged", flagged.size(), 1u);
+    ensure_equals("sql", flagged[0], utf("select count(*) from some_table where salary > 0"));
+    ensure("steps", flagged_steps > 15);
+
+    // metrics keep counting, the guard counts from the flag
+    unsigned long long const total = st.metrics().fullscan_steps;
+    ensure("not reset", total >= flagged_steps);
+    st.reset();
+    ensure("row third", st.exec());
+    ensure("done third", !st.exec());
+    ensure_equals("not again", flagged.size(), 1u);
+    ensure("monotonic", st.metrics().fullscan_steps > total);
+    st.reset();
+    ensure("row fourth", st.exec());
+    ensure("done fourth", !st.exec());
+    ensure_equals("flagged again", flagged.size(), 2u);
+    ensure("steps since flag", flagged_steps > 15 && flagged_steps < st.metrics().fullscan_steps);
+    st.reset();
+
+    se.set_fullscan_guard(0, [](text const&, unsigned long long)
+    {
+        throw std::runtime_error("full scan");
+    });
+    try
+    {
+        se << utf("update some_table set salary = salary + 1 where salary > 0");
+        fail("exception expected");
+    }
+    catch (std::runtime_error const& e)
+    {
+        ensure_equals("thrown", std::string(e.what()), "full scan");
+    }
+    se.clear_fullscan_guard();
+    se << utf("update some_table set salary = salary + 1 where salary > 0");
+}
+
+// column names are indexed again after reprepare
+template<>template<>
+void object::test<10>()
+{
+    se << utf("create table renamed(a integer, b text)");
+    se << utf("insert into renamed values(1, 'x')");
+    // finalized before the fixture drops its table
+    statement select(se, utf("select * from renamed"));
+    ensure("row", select.exec());
+    ensure_equals("a", select.column_index(utf("a")), 0);
+    select.reset();
+
+    se << utf("alter table renamed rename column a to c");
+    ensure("reprepared row", select.exec());
+    ensure_equals("c", select.column_index(utf("c")), 0);
+    try
+    {
+        select.column_index(utf("a"));
+        fail("exception expected");
+    }
+    catch (no_such_column const&)
+    {
+    }
+}
+
 } // namespace tut {
@@ -0,0 +1,108 @@
+#include <tut.h>
+
+#include <sqlitepp/statement_cache.hpp>
+#include <sqlitepp/exception.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "statement_data.hpp"
+
+using namespace sqlitepp;
+
+namespace tut {
+
+struct statement_cache_data : statement_data
+{
+};
+
+typedef tut::test_group<statement_cache_data> statement_cache_test_group;
+typedef statement_cache_test_group::object object;
+
+statement_cache_test_group sc_g("10. statement cache");
+
+// repeated once queries hit the cache
+template<>template<>
+void object::test<1>()
+{
+    statement_cache& cache = se.cache();
+    unsigned long long const hits = cache.hits();
+    unsigned long long const misses = cache.misses();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        se << utf("insert into some_table(id, name, salary) values(:id, 'x', 1.0)"), use(i);
+    }
+    ensure_equals("misses", cache.misses(), misses + 1);
+    ensure_equals("hits", cache.hits(), hits + 9);
+
+    int count;
+    se << utf("select count(*) from some_table"), into(count);
+    ensure_equals("rows inserted", count, 10);
+}
+
+// cached statement is reset and its bindings cleared
+template<>template<>
+void object::test<2>()
+{
+    record r(1, utf("Kolya"), 12.3);
+    r.insert(se);
+
+    int id = 0;
+    st << utf("select id from some_table"), into(id);
+    ensure("row", st.exec());
+    st.finalize();
+    ensure("not prepared", !st.is_prepared());
+
+    id = 0;
+    st << utf("select id from some_table"), into(id);
+    ensure("row from start", st.exec());
+    ensure_equals("id", id, r.id);
+    ensure("no more rows", !st.exec());
+
+    string_t name = utf("unbound");
+    st << utf("select ?"), into(name);
+    st.exec();
+    st << utf("select ?"), into(name);
+    st.exec();
+    ensure("bindings cleared", name.empty());
+}
+
+// capacity limits cache size and counts evictions
+template<>template<>
+void object::test<3>()
+{
+    statement_cache& cache = se.cache();
+    cache.clear();
+    cache.capacity(2);
+    unsigned long long const evictions = cache.evictions();
+
+    se << utf("select 1");
+    se << utf("select 2");
+    se << utf("select 3");
+    ensure_equals("size", cache.size(), 2u);
+    ensure_equals("evictions", cache.evictions(), evictions + 1);
+
+    cache.capacity(0);
+    ensure_equals("size", cache.size(), 0u);
+    se << utf("select 1");
+    ensure_equals("disabled", cache.size(), 0u);
+}
+
+// broken statements are not cached
+template<>template<>
+void object::test<4>()
+{
+    for (int i = 0; i < 2; ++i)
+    {
+        try
+        {
+            se << utf("select 1; select 2");
+            fail("exception expected");
+        }
+        catch (multi_stmt_not_supported const&)
+        {
+        }
+    }
+}
+
+} // namespace tut {
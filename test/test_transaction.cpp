@@ -61,19 +61,87 @@ void object::test<2>()
 template<>template<>
 void object::test<3>()
 {
+    int rows;
     transaction t1(se, transaction::immediate);
-    try
+    ensure( "outer not nested", !t1.is_nested() );
+    record(1, utf("Kostya"), 1.0).insert(se);
     {
         transaction t2(se, transaction::exclusive);
-        fail("nested_txn_exception expected");
+        ensure( "inner nested", t2.is_nested() );
+        ensure_equals( "inner parent", t2.parent(), &t1 );
+        ensure_equals( "inner active", se.active_txn(), &t2 );
+
+        record(2, utf("Misha"), 2.0).insert(se);
+        se << utf("select count(*) from some_table"), into(rows);
+        ensure_equals("rows in inner", rows, 2);
     }
-    catch (nested_txn_not_supported const&)
+    ensure_equals( "outer active", se.active_txn(), &t1 );
+    se << utf("select count(*) from some_table"), into(rows);
+    ensure_equals("inner rollback", rows, 1);
+
     {
+        transaction t2(se);
+        record(3, utf("Grisha"), 3.0).insert(se);
+        t2.commit();
     }
-    catch (...)
+    t1.commit();
+    ensure( "no active txn", !se.active_txn() );
+    se << utf("select count(*) from some_table"), into(rows);
+    ensure_equals("inner commit", rows, 2);
+}
+
+// outer transaction ends nested ones
+template<>template<>
+void object::test<4>()
+{
+    int rows;
+    transaction t1(se);
+    transaction t2(se);
+    transaction t3(se);
+    record(1, utf("Petya"), 1.0).insert(se);
+    t2.commit();
+    ensure_equals( "outer active", se.active_txn(), &t1 );
+    t3.rollback(); // no-op, already released with t2
+
+    t1.rollback();
+    ensure( "no active txn", !se.active_txn() );
+    se << utf("select count(*) from some_table"), into(rows);
+    ensure_equals("all rolled back", rows, 0);
+}
+
+// end of outer nested transaction while inner ones are open
+template<>template<>
+void object::test<5>()
+{
+    int rows;
+    {
+        transaction t1(se);
+        transaction t2(se);
+        record(1, utf("Petya"), 1.0).insert(se);
+        transaction t3(se);
+        record(2, utf("Vasya"), 2.0).insert(se);
+        t2.rollback();
+        ensure_equals( "outer active", se.active_txn(), &t1 );
+        t1.commit();
+    }
+    se << utf("select count(*) from some_table"), into(rows);
+    ensure_equals("nested rolled back", rows, 0);
+
     {
-        fail("nested_txn_not_supported expected");
+        transaction t1(se);
+        record(1, utf("Petya"), 1.0).insert(se);
+        transaction t2(se);
+        transaction t3(se);
+        record(2, utf("Vasya"), 2.0).insert(se);
+        t2.commit();
+        record(3, utf("Kolya"), 3.0).insert(se);
+        transaction t4(se);
+        record(4, utf("Sasha"), 4.0).insert(se);
+        t4.rollback();
+        t1.commit();
     }
+    se << utf("select count(*) from some_table"), into(rows);
+    ensure_equals("nested committed", rows, 3);
 }
 
 } // namespace
@@ -0,0 +1,155 @@
+#include <stdexcept>
+
+#include <tut.h>
+
+#include <sqlitepp/typed_statement.hpp>
+#include <sqlitepp/exception.hpp>
+
+#include "statement_data.hpp"
+
+using namespace sqlitepp;
+
+namespace tut {
+
+struct typed_statement_data : statement_data
+{
+};
+
+typedef tut::test_group<typed_statement_data> typed_statement_test_group;
+typedef typed_statement_test_group::object object;
+
+typed_statement_test_group ts_g("13. typed statement");
+
+// insert and query rows as tuples
+template<>template<>
+void object::test<1>()
+{
+    typed_statement<std::tuple<>(int, string_t, double)> insert(se,
+        utf("insert into some_table(id, name, salary) values(?, ?, ?)"));
+    insert.exec(1, utf("Petya"), 123.45);
+    insert.exec(2, utf("Vasya"), 678.90);
+    insert.exec(3, utf("Kolya"), 0.5);
+
+    typed_statement<std::tuple<int, string_t, double>(int)> select(se,
+        utf("select id, name, salary from some_table where id > ? order by id"));
+    auto rows = select.query(1);
+    ensure_equals("row count", rows.size(), 2u);
+    ensure_equals("id", std::get<0>(rows[0]), 2);
+    ensure_equals("name", std::get<1>(rows[0]), utf("Vasya"));
+    ensure_equals("salary", std::get<2>(rows[0]), 678.90);
+    ensure_equals("id", std::get<0>(rows[1]), 3);
+    ensure_equals("name", std::get<1>(rows[1]), utf("Kolya"));
+
+    // statement is reused with other parameters
+    rows = select.query(0);
+    ensure_equals("row count", rows.size(), 3u);
+    ensure_equals("name", std::get<1>(rows[0]), utf("Petya"));
+}
+
+// fetch rows one by one, converters and nulls
+template<>template<>
+void object::test<2>()
+{
+    se << utf("insert into some_table values(1, 'Misha', 1.0, x'787878')");
+    se << utf("insert into some_table(id, name) values(2, NULL)");
+
+    typed_statement<std::tuple<long long, string_t, bool, std::vector<char>>()> select(se,
+        utf("select id, name, salary, data from some_table order by id"));
+    select.bind();
+
+    std::tuple<long long, string_t, bool, std::vector<char>> row;
+    ensure("first row", select.fetch(row));
+    ensure_equals("id", std::get<0>(row), 1);
+    ensure_equals("name", std::get<1>(row), utf("Misha"));
+    ensure("salary", std::get<2>(row));
+    ensure_equals("data", std::get<3>(row).size(), 3u);
+
+    ensure("second row", select.fetch(row));
+    ensure_equals("id", std::get<0>(row), 2);
+    ensure("null name", std::get<1>(row).empty());
+    ensure("null salary", !std::get<2>(row));
+    ensure("null data", std::get<3>(row).empty());
+
+    ensure("no more rows", !select.fetch(row));
+}
+
+// column and parameter count are checked on prepare
+template<>template<>
+void object::test<3>()
+{
+    try
+    {
+        typed_statement<std::tuple<int>(int)> ts(se, utf("select id, name from some_table where id = ?"));
+        fail("column count mismatch expected");
+    }
+    catch (std::invalid_argument const&)
+    {
+    }
+
+    try
+    {
+        typed_statement<std::tuple<int>()> ts(se, utf("select id from some_table where id = ?"));
+        fail("parameter count mismatch expected");
+    }
+    catch (std::invalid_argument const&)
+    {
+    }
+
+    try
+    {
+        typed_statement<std::tuple<int>()> ts(se, utf("select id from no_such_table"));
+        fail("exception expected");
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+}
+
+// view columns are tracked until the next row
+template<>template<>
+void object::test<4>()
+{
+    se << utf("insert into some_table(id, name) values(1, 'one')");
+    se << utf("insert into some_table(id, name) values(2, 'two')");
+    typed_statement<std::tuple<int, text>()> ts(se, utf("select id, name from some_table order by id"));
+    ts.bind();
+    std::tuple<int, text> row;
+    ensure("first", ts.fetch(row));
+    char const* const first = std::get<1>(row).data;
+    ensure_equals("name", std::string(first), "one");
+    ensure("valid view", ts.st().is_valid_view(first));
+    ensure("second", ts.fetch(row));
+    ensure("valid next view", ts.st().is_valid_view(std::get<1>(row).data));
+#ifndef NDEBUG
+    ensure("previous view", !ts.st().is_valid_view(first) || first == std::get<1>(row).data);
+#endif
+}
+
+// query and exec bind parameters for the call only
+template<>template<>
+void object::test<5>()
+{
+    typed_statement<std::tuple<>(int, u8string)> insert(se, utf("insert into some_table(id, name) values(?, ?)"));
+    for (int i = 1; i <= 2; ++i)
+    {
+        insert.exec(i, u8string(utf("name ")) + std::to_string(i));
+    }
+    typed_statement<std::tuple<int>(u8string)> select(se, utf("select id from some_table where name = ?"));
+    ensure_equals("first", std::get<0>(select.query(u8string(utf("name 1"))).at(0)), 1);
+    ensure_equals("second", std::get<0>(select.query(u8string(utf("name 2"))).at(0)), 2);
+
+    std::tuple<int> row;
+    try
+    {
+        select.fetch(row);
+        fail("exception expected");
+    }
+    catch (std::logic_error const&)
+    {
+    }
+    select.bind(u8string(utf("name 2")));
+    ensure("bound", select.fetch(row));
+    ensure_equals("fetched", std::get<0>(row), 2);
+}
+
+} // namespace
@@ -1,3 +1,7 @@
+#include <cstdint>
+#include <memory>
+#include <vector>
+
 #include <tut.h>
 
 #include <sqlitepp/exception.hpp>
@@ -191,4 +195,93 @@ void object::test<6>()
     ensure_equals("row count", count, 4);
 }
 
+// binders in query storage, heap allocated binders and rebinding
+template<>template<>
+void object::test<7>()
+{
+    int id = 1;
+    string_t name = utf("first");
+    double salary = 1.5;
+    use_binder_ptr u = use(salary, utf(":salary"));
+
+    st << utf("insert into some_table(id, name, salary) values(:id, :name, :salary)"),
+        use(id), use(name, utf(":name")), std::move(u);
+    st.exec();
+
+    id = 2; name = utf("second, longer than a short string"); salary = 2.5;
+    st.reset(true);
+    st.exec();
+
+    // more binders than fit into one storage block
+    int sum = 0;
+    st << utf("select id + :a1 + :a2 + :a3 + :a4 + :a5 + :a6 + :a7 + :a8 + :a9 + :a10 + "
+        ":a11 + :a12 + :a13 + :a14 + :a15 + :a16 + :a17 + :a18 + :a19 + :a20 "
+        "from some_table where id = 2"), into(sum);
+    for (int i = 1; i <= 20; ++i) st.q().put(use(i + 0));
+    ensure("row", st.exec());
+    ensure_equals("sum", sum, 2 + 210);
+
+    string_t name2;
+    double salary2 = 0;
+    st << utf("select name, salary from some_table order by id"), into(name2), into(salary2);
+    ensure("first row", st.exec());
+    ensure_equals("first name", name2, utf("first"));
+    ensure_equals("first salary", salary2, 1.5);
+    ensure("second row", st.exec());
+    ensure_equals("second name", name2, utf("second, longer than a short string"));
+    ensure_equals("second salary", salary2, 2.5);
+    ensure("no more rows", !st.exec());
+}
+
+// values moved into statement
+template<>template<>
+void object::test<8>()
+{
+    st << utf("insert into some_table(id, name, data) values(?, ?, ?)");
+    st.prepare();
+    for (int id = 1; id <= 3; ++id)
+    {
+        string_t name(id * 100, 'a' + id);
+        std::vector<std::uint8_t> data(id, static_cast<std::uint8_t>(id));
+        st.use_value(1, id);
+        st.use_value(2, std::move(name));
+        st.use_value(3, std::move(data));
+        st.exec();
+        st.reset();
+    }
+
+    std::unique_ptr<char[]> chars(new char[3]);
+    chars[0] = 'x'; chars[1] = 'y'; chars[2] = 'z';
+    st.use_value(1, 4);
+    st.use_value(2, std::move(chars), 2);
+    st.use_value(3, std::vector<std::uint8_t>());
+    st.exec();
+    st.reset();
+
+    try
+    {
+        st.use_value(4, string_t(utf("out of range")));
+        fail( "exception expected" );
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+
+    int id = 0;
+    string_t name;
+    record::blob_data data;
+    st << utf("select id, name, data from some_table order by id"), into(id), into(name), into(data);
+    for (int i = 1; i <= 3; ++i)
+    {
+        ensure("row", st.exec());
+        ensure_equals("name", name, string_t(i * 100, 'a' + i));
+        ensure_equals("data size", data.size(), static_cast<std::size_t>(i));
+    }
+    ensure("unique_ptr row", st.exec());
+    ensure_equals("unique_ptr name", name, utf("xy"));
+    ensure("empty blob", data.empty());
+    ensure_equals("empty blob type", st.column_type(2), statement::blob);
+    ensure("no more rows", !st.exec());
+}
+
 } // namespace
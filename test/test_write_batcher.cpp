@@ -0,0 +1,158 @@
+#include <stdio.h>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <tut.h>
+
+#include <sqlitepp/write_batcher.hpp>
+#include <sqlitepp/exception.hpp>
+#include <sqlitepp/into.hpp>
+#include <sqlitepp/use.hpp>
+
+#include "session_data.hpp"
+
+using namespace sqlitepp;
+
+namespace tut {
+
+struct write_batcher_data : session_data
+{
+    write_batcher_data() : session_data(utf("batch.db"))
+    {
+        se << utf("create table log(id integer primary key, thread integer)");
+    }
+};
+
+typedef tut::test_group<write_batcher_data> write_batcher_test_group;
+typedef write_batcher_test_group::object object;
+
+write_batcher_test_group wb_g("11. write batcher");
+
+// writes from many threads are committed with their results
+template<>template<>
+void object::test<1>()
+{
+    int const threads = 4, writes = 100;
+    write_batcher::options opts;
+    opts.max_batch = 64;
+    write_batcher wb(name_, opts);
+
+    std::vector<std::thread> producers;
+    std::vector<long long> rowids(threads * writes);
+    for (int t = 0; t < threads; ++t)
+    {
+        producers.emplace_back([&, t]
+        {
+            std::vector<std::future<long long>> results;
+            for (int i = 0; i < writes; ++i)
+            {
+                results.push_back(wb.submit([t](session& s)
+                {
+                    s << utf("insert into log(thread) values(:t)"), use(t);
+                    return s.last_insert_rowid();
+                }));
+            }
+            for (int i = 0; i < writes; ++i) rowids[t * writes + i] = results[i].get();
+        });
+    }
+    for (auto& p : producers) p.join();
+
+    ensure_equals("writes", wb.writes(), (unsigned long long)(threads * writes));
+    ensure("batched", wb.batches() >= 1 && wb.batches() <= wb.writes());
+    for (auto id : rowids) ensure("rowid", id > 0);
+
+    int count;
+    se << utf("select count(*) from log"), into(count);
+    ensure_equals("committed", count, threads * writes);
+}
+
+// failed write is rolled back alone
+template<>template<>
+void object::test<2>()
+{
+    write_batcher::options opts;
+    opts.max_delay = std::chrono::milliseconds(50);
+    write_batcher wb(name_, opts);
+
+    auto ok1 = wb.submit([](session& s) { s << utf("insert into log(thread) values(1)"); });
+    auto bad = wb.submit([](session& s)
+    {
+        s << utf("insert into log(thread) values(2)");
+        s << utf("insert into no_such_table values(2)");
+    });
+    auto ok2 = wb.submit([](session& s) { s << utf("insert into log(thread) values(3)"); });
+
+    ok1.get();
+    ok2.get();
+    try
+    {
+        bad.get();
+        fail("exception expected");
+    }
+    catch (sqlitepp::exception const&)
+    {
+    }
+
+    int count;
+    se << utf("select count(*) from log where thread <> 2"), into(count);
+    ensure_equals("committed", count, 2);
+    se << utf("select count(*) from log where thread = 2"), into(count);
+    ensure_equals("rolled back", count, 0);
+}
+
+// submit after stop
+template<>template<>
+void object::test<3>()
+{
+    write_batcher wb(name_);
+    auto r = wb.submit([](session& s) { s << utf("insert into log(thread) values(1)"); });
+    wb.stop();
+    r.get();
+    try
+    {
+        wb.submit([](session&) {});
+        fail("exception expected");
+    }
+    catch (std::logic_error const&)
+    {
+    }
+}
+
+// stop while producers are still submitting
+template<>template<>
+void object::test<4>()
+{
+    for (int round = 0; round < 5; ++round)
+    {
+        write_batcher wb(name_);
+        std::vector<std::vector<std::future<void>>> results(4);
+        std::vector<std::thread> producers;
+        for (auto& r : results)
+        {
+            producers.emplace_back([&wb, &r]
+            {
+                try
+                {
+                    for (;;) r.push_back(wb.submit([](session& s) { s << utf("insert into log(thread) values(1)"); }));
+                }
+                catch (std::logic_error const&)
+                {
+                }
+            });
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        wb.stop();
+        for (auto& p : producers) p.join();
+
+        for (auto& r : results)
+        {
+            for (auto& f : r)
+            {
+                ensure("completed", f.wait_for(std::chrono::seconds(5)) == std::future_status::ready);
+            }
+        }
+    }
+}
+
+} // namespace tut {